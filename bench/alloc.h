@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstddef>
+
+/*
+ * Heap usage counters of the benchmark program
+ * Filled by the global operator new/delete replacements in bench/main.cpp
+ */
+namespace bench_alloc {
+std::size_t current(); // Bytes currently allocated
+std::size_t peak();    // Highest value of current() since the last reset
+void resetPeak();      // Sets peak() back to current()
+std::size_t count();   // Number of allocations since the start
+} // namespace bench_alloc
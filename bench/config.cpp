@@ -0,0 +1,85 @@
+#include "../src/include/config.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <sys/stat.h>
+
+namespace config_bench {
+
+// Keys pressed by the benchmark, bound keys & a few unbound ones
+static const char KEYS[] = "wasdfxerqozp1 ";
+
+/*
+ * Decodes a key with one getConfig call per binding, the way the game did
+ * before the keymap
+ *
+ * @param config Config to read the bindings from
+ * @param inp    Key that was pressed
+ * @return KeyInput
+ */
+KeyInput decodeByLookup(Config &config, char inp) {
+    if (inp == config.getConfig(Config::KB_UP)[0])
+        return KeyInput::Up;
+    else if (inp == config.getConfig(Config::KB_DOWN)[0])
+        return KeyInput::Down;
+    else if (inp == config.getConfig(Config::KB_LEFT)[0])
+        return KeyInput::Left;
+    else if (inp == config.getConfig(Config::KB_RIGHT)[0])
+        return KeyInput::Right;
+    else if (inp == config.getConfig(Config::KB_CONFIRM)[0])
+        return KeyInput::Confirm;
+    else if (inp == config.getConfig(Config::KB_CANCEL)[0])
+        return KeyInput::Cancel;
+    else if (inp == config.getConfig(Config::KB_USE_PICKAXE)[0])
+        return KeyInput::UsePickaxe;
+    else if (inp == config.getConfig(Config::KB_USE_RATION)[0])
+        return KeyInput::UseRation;
+    else if (inp == config.getConfig(Config::KB_EXIT)[0])
+        return KeyInput::Exit;
+    else if (inp == config.getConfig(Config::KB_OVERLAY)[0])
+        return KeyInput::ToggleOverlay;
+    return KeyInput::None;
+}
+
+/*
+ * Times the decoding of key presses, one getConfig per binding against the
+ * keymap
+ */
+void benchDecode() {
+    std::string dir = "/tmp/config_bench/";
+    mkdir(dir.c_str(), 0777);
+    setenv("XDG_CONFIG_HOME", dir.c_str(), 1);
+    Config config;
+
+    const int presses = 20000, keys = sizeof(KEYS) - 1;
+    int found = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < presses; i++)
+        found += decodeByLookup(config, KEYS[i % keys]) != KeyInput::None;
+    auto end = std::chrono::steady_clock::now();
+    std::cout << "getConfig per binding: "
+              << std::chrono::duration<double, std::nano>(end - start)
+                         .count() /
+                     presses
+              << " ns/key (" << found << " bound)" << std::endl;
+
+    found = 0;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < presses * 100; i++)
+        found += config.getKeyInput(KEYS[i % keys]) != KeyInput::None;
+    end = std::chrono::steady_clock::now();
+    std::cout << "Keymap: "
+              << std::chrono::duration<double, std::nano>(end - start)
+                         .count() /
+                     (presses * 100)
+              << " ns/key (" << found / 100 << " bound)" << std::endl;
+}
+
+void runAll() {
+    std::cout << "Running Config benchmarks..." << std::endl;
+    benchDecode();
+    std::cout << "All Config benchmarks done!" << std::endl;
+}
+
+} // namespace config_bench
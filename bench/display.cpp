@@ -0,0 +1,249 @@
+#include "../src/include/display.h"
+#include "../src/include/level.h"
+#include "../src/include/player.h"
+#include "../src/include/renderer.h"
+#include "alloc.h"
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <ncurses.h>
+#include <sys/stat.h>
+#include <string>
+#include <vector>
+
+namespace display_bench {
+
+/*
+ * Times drawLevel for a level
+ * Frames are presented to whatever renderer Display has
+ *
+ * @param level  Level to draw
+ * @param frames Number of frames to draw
+ * @return double Average microseconds per frame
+ */
+double timeDrawLevel(const Level &level, int frames) {
+    Player player;
+    player.setPos(level.getStart());
+    std::string text;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < frames; i++) {
+        Display::flush();
+        Display::drawLevel(level, player, 1, text);
+        Display::present();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(end - start).count() /
+           frames;
+}
+
+/*
+ * Same color pairs as Display::initCurses, curses skips attribute changes
+ * between pairs that were never defined, which would hide the real output
+ */
+void initColors() {
+    start_color();
+    init_pair(1, COLOR_YELLOW, COLOR_BLACK);
+    init_pair(2, COLOR_WHITE, COLOR_WHITE);
+    init_pair(3, COLOR_BLACK, COLOR_BLACK);
+    init_pair(4, COLOR_RED, COLOR_RED);
+    init_pair(5, COLOR_GREEN, COLOR_BLACK);
+    init_pair(6, COLOR_WHITE, COLOR_BLACK);
+    init_pair(7, COLOR_WHITE, COLOR_BLACK);
+    init_pair(8, COLOR_MAGENTA, COLOR_BLACK);
+}
+
+void benchDrawLevel() {
+    // Only the drawing is timed, the frames go nowhere
+    Display::setRenderer(Renderer::create(RendererType::Null, 40, 120));
+
+    // Frame time should not depend on the size of the map
+    int sizes[] = {25, 100, 250, 500, 1000, 4000};
+    double results[7];
+    for (int i = 0; i < 6; i++)
+        results[i] = timeDrawLevel(Level(sizes[i], Vector2D(0, 0), 4, 1340), 50);
+    results[6] = timeDrawLevel(Level::chunked(16001, Vector2D(0, 0), 4,
+                                              GeneratorType::Backtracker, 1340),
+                               50);
+
+    for (int i = 0; i < 6; i++)
+        std::cout << "drawLevel " << sizes[i] << "x" << sizes[i] << ": "
+                  << results[i] << " us/frame" << std::endl;
+    std::cout << "drawLevel 16001x16001 (chunked): " << results[6]
+              << " us/frame" << std::endl;
+}
+
+// Bytes curses has written to a terminal that is a file
+std::size_t terminalBytes(FILE *out) {
+    struct stat info;
+    fstat(fileno(out), &info);
+    return std::size_t(info.st_size);
+}
+
+/*
+ * Gets the tiles from the start to the exit, following the distance field
+ *
+ * @param level Level to walk through
+ * @return std::vector<Vector2D>
+ */
+std::vector<Vector2D> walkToExit(const Level &level) {
+    Vector2D dirs[] = {Vector2D(-1, 0), Vector2D(1, 0), Vector2D(0, -1),
+                       Vector2D(0, 1)};
+    std::vector<Vector2D> path(1, level.getEnd());
+    while (level.getDistance(path.back()) > 0) {
+        for (Vector2D dir : dirs) {
+            Vector2D next = path.back() + dir;
+            if (level.getDistance(next) == level.getDistance(path.back()) - 1) {
+                path.push_back(next);
+                break;
+            }
+        }
+    }
+    return std::vector<Vector2D>(path.rbegin(), path.rend());
+}
+
+/*
+ * Compares what reaches the terminal when every frame is repainted from
+ * scratch (the old clear() + refresh()) with presenting only the changes
+ * The player walks from the start to the exit, one step per frame
+ */
+void benchFrameDiff() {
+    FILE *out = tmpfile();
+    SCREEN *screen = newterm("xterm", out, stdin);
+    if (screen == nullptr) {
+        std::cout << "Could not create curses screen, skipped" << std::endl;
+        fclose(out);
+        return;
+    }
+    resizeterm(40, 120);
+    initColors();
+    Display::setRenderer(Renderer::create(RendererType::Curses));
+
+    Level level(101, Vector2D(0, 0), 4, 1340);
+    std::vector<Vector2D> path = walkToExit(level);
+    std::string text;
+    for (int repaint = 1; repaint >= 0; repaint--) {
+        Player player;
+        long cells = 0, estimate = 0, calls = 0;
+        std::size_t before = terminalBytes(out);
+        auto start = std::chrono::steady_clock::now();
+        for (Vector2D pos : path) {
+            player.setPos(pos);
+            Display::flush();
+            Display::drawLevel(level, player, 1, text);
+            if (repaint) {
+                Display::getScreen().invalidate();
+                clearok(stdscr, TRUE);
+            }
+            Display::present();
+            cells += Display::getScreen().getLastFrame().cells;
+            estimate += Display::getScreen().getLastFrame().bytes;
+            calls += static_cast<CursesRenderer &>(Display::getRenderer())
+                         .getLastCalls();
+        }
+        auto end = std::chrono::steady_clock::now();
+        double frames = double(path.size());
+        std::cout << (repaint ? "Full repaint: " : "Damage only:  ")
+                  << cells / frames << " cells, "
+                  << (terminalBytes(out) - before) / frames
+                  << " terminal bytes (estimate " << estimate / frames
+                  << "), " << calls / frames << " curses calls ("
+                  << cells / frames + 1 << " one cell at a time), "
+                  << std::chrono::duration<double, std::micro>(end - start)
+                             .count() /
+                         frames
+                  << " us per frame over " << path.size() << " steps"
+                  << std::endl;
+    }
+
+    endwin();
+    delscreen(screen);
+    fclose(out);
+}
+
+/*
+ * Times the same walk to the exit with every backend, the difference with
+ * the null backend is what presenting a frame costs
+ */
+void benchBackends() {
+    FILE *devNull = fopen("/dev/null", "w");
+    SCREEN *screen = newterm("xterm", devNull, stdin);
+    if (screen == nullptr) {
+        std::cout << "Could not create curses screen, skipped" << std::endl;
+        fclose(devNull);
+        return;
+    }
+    resizeterm(40, 120);
+    initColors();
+
+    Level level(101, Vector2D(0, 0), 4, 1340);
+    std::vector<Vector2D> path = walkToExit(level);
+    RendererType types[] = {RendererType::Null, RendererType::Framebuffer,
+                            RendererType::Curses};
+    std::string text;
+    for (RendererType type : types) {
+        Display::setRenderer(Renderer::create(type, 40, 120));
+        Player player;
+        auto start = std::chrono::steady_clock::now();
+        for (Vector2D pos : path) {
+            player.setPos(pos);
+            Display::flush();
+            Display::drawLevel(level, player, 1, text);
+            Display::present();
+        }
+        auto end = std::chrono::steady_clock::now();
+        std::cout << "Backend " << Display::getRenderer().getName() << ": "
+                  << std::chrono::duration<double, std::micro>(end - start)
+                             .count() /
+                         path.size()
+                  << " us per frame" << std::endl;
+    }
+
+    endwin();
+    delscreen(screen);
+    fclose(devNull);
+}
+
+/*
+ * Times the level HUD: frames where the stats stay the same, and frames where
+ * the stamina changes every frame like it does while walking
+ */
+void benchHUD() {
+    Display::setRenderer(Renderer::create(RendererType::Null, 40, 120));
+    Level level(100, Vector2D(0, 0), 4, 1340);
+    Player player;
+    player.setPos(level.getStart());
+    std::string text;
+    const int frames = 2000;
+
+    for (int changing = 0; changing < 2; changing++) {
+        std::size_t allocs = bench_alloc::count();
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < frames; i++) {
+            if (changing)
+                player.setStamina(i % 100);
+            Display::flush();
+            Display::drawLevel(level, player, 1, text);
+            Display::present();
+        }
+        auto end = std::chrono::steady_clock::now();
+        std::cout << (changing ? "HUD, stamina changing: " : "HUD, same stats:       ")
+                  << std::chrono::duration<double, std::micro>(end - start)
+                             .count() /
+                         frames
+                  << " us/frame, "
+                  << double(bench_alloc::count() - allocs) / frames
+                  << " allocations/frame" << std::endl;
+    }
+}
+
+void runAll() {
+    std::cout << "Running Display benchmarks..." << std::endl;
+    benchDrawLevel();
+    benchFrameDiff();
+    benchBackends();
+    benchHUD();
+    std::cout << "All Display benchmarks done!" << std::endl;
+}
+
+} // namespace display_bench
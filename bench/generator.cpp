@@ -0,0 +1,85 @@
+#include "../src/include/generator.h"
+#include "../src/include/mazestream.h"
+#include "alloc.h"
+#include <chrono>
+#include <iostream>
+#include <memory>
+
+namespace generator_bench {
+
+/*
+ * Times one run of a generator and measures the heap it needs on top of the
+ * tile map
+ *
+ * @param type Generator to run
+ * @param size Size of the square maze
+ */
+void benchGenerator(GeneratorType type, int size) {
+    std::unique_ptr<MazeGenerator> generator = MazeGenerator::create(type);
+    TileMap maze(size, size, TileObject::Wall, TileObject::Border);
+
+    Random rng(1340);
+    std::size_t base = bench_alloc::current();
+    bench_alloc::resetPeak();
+    auto start = std::chrono::steady_clock::now();
+    generator->generate(maze, Vector2D(0, 0), rng);
+    auto end = std::chrono::steady_clock::now();
+    double ms = std::chrono::duration<double, std::milli>(end - start).count();
+    std::size_t extra = bench_alloc::peak() - base;
+
+    std::cout << generator->getName() << " " << size << "x" << size << ": "
+              << ms << " ms, " << double(size) * size / ms / 1000
+              << " Mtiles/s, " << extra / 1024 << " KiB peak ("
+              << double(extra) / (double(size) * size) << " bytes/tile)"
+              << std::endl;
+}
+
+// Sink that only counts the open tiles it receives
+class CountingSink : public RowSink {
+  public:
+    long long open = 0;
+    void consumeRow(int y, const TileObject *row, int width) {
+        for (int x = 0; x < width; x++)
+            open += row[x] == TileObject::None;
+    }
+};
+
+/*
+ * Streams an Eller's maze without storing it, to show that memory depends on
+ * the width only
+ *
+ * @param height Number of rows to stream
+ * @param width  Number of tiles per row
+ */
+void benchEllerStream(int height, int width) {
+    CountingSink sink;
+    Random rng(1340);
+    std::size_t base = bench_alloc::current();
+    bench_alloc::resetPeak();
+    auto start = std::chrono::steady_clock::now();
+    EllerStream(height, width, Vector2D(0, 0), rng, sink).run();
+    auto end = std::chrono::steady_clock::now();
+    double ms = std::chrono::duration<double, std::milli>(end - start).count();
+
+    std::cout << "Eller stream " << height << "x" << width << ": " << ms
+              << " ms, " << double(height) * width / ms / 1000
+              << " Mtiles/s, " << (bench_alloc::peak() - base) / 1024
+              << " KiB peak" << std::endl;
+}
+
+void runAll() {
+    std::cout << "Running Generator benchmarks..." << std::endl;
+    GeneratorType types[] = {GeneratorType::Prim,    GeneratorType::PrimBitboard,
+                             GeneratorType::Backtracker, GeneratorType::Kruskal,
+                             GeneratorType::Wilson,  GeneratorType::Eller};
+    int sizes[] = {101, 1001, 2001};
+    for (int size : sizes)
+        for (GeneratorType type : types)
+            benchGenerator(type, size);
+    int heights[] = {1001, 10001, 40001};
+    for (int height : heights)
+        benchEllerStream(height, 2001);
+    std::cout << "All Generator benchmarks done!" << std::endl;
+}
+
+} // namespace generator_bench
@@ -0,0 +1,189 @@
+#include "alloc.h"
+#include "../src/include/level.h"
+#include "../src/include/prefetch.h"
+#include "../src/include/vector2d.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+namespace level_bench {
+
+/*
+ * Times the construction of a single level of the given size
+ *
+ * @param size Size of the square maze
+ * @param mode Generation mode to use
+ * @return double Milliseconds taken to build the level
+ */
+double timeLevel(int size,
+                 GenerationMode mode = GenerationMode::Scalar) {
+    PrimGenerator generator(mode);
+    auto start = std::chrono::steady_clock::now();
+    Level level(size, Vector2D(0, 0), 4, generator, 1340);
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+void benchGeneration() {
+    int sizes[] = {250, 500, 1000, 2000, 4000};
+    double prevPerTile = 0;
+    for (int size : sizes) {
+        double ms = timeLevel(size);
+        double perTile = ms * 1e6 / (double(size) * size); // ns per tile
+        std::cout << "Level " << size << "x" << size << ": " << ms << " ms ("
+                  << perTile << " ns/tile";
+        if (prevPerTile > 0)
+            std::cout << ", x" << perTile / prevPerTile << " vs previous";
+        std::cout << ")" << std::endl;
+        prevPerTile = perTile;
+    }
+}
+
+void benchGenerationModes() {
+    int sizes[] = {100, 1000, 4000};
+    for (int size : sizes) {
+        double scalar = timeLevel(size, GenerationMode::Scalar);
+        double bitboard = timeLevel(size, GenerationMode::Bitboard);
+        std::cout << "Level " << size << "x" << size << ": scalar " << scalar
+                  << " ms, bitboard " << bitboard << " ms (x"
+                  << scalar / bitboard << ")" << std::endl;
+    }
+}
+
+void benchMemory() {
+    int size = 1000;
+    Level level(size, Vector2D(0, 0), 4, 1340);
+    TileView maze = level.getView();
+    std::size_t bytes =
+        std::size_t(maze.getHeight() + 2) * maze.getStride() * sizeof(TileObject);
+    std::cout << "Tile map " << size << "x" << size << ": " << bytes
+              << " bytes (" << double(bytes) / (double(size) * size)
+              << " bytes/tile, " << sizeof(TileObject) << " byte TileObject)"
+              << std::endl;
+}
+
+/*
+ * Compares the stall on the exit tile with & without prefetching
+ * The prefetched level is given time to finish, like it would while the
+ * player walks through the current layer
+ */
+void benchPrefetch() {
+    int sizes[] = {101, 501, 1001};
+    for (int size : sizes) {
+        LevelPrefetcher::Params params = {size, Vector2D(0, 0), 4,
+                                          GeneratorType::Wilson, 1340};
+        LevelPrefetcher prefetcher;
+
+        auto start = std::chrono::steady_clock::now();
+        Level sync = prefetcher.take(params);
+        auto end = std::chrono::steady_clock::now();
+        double syncMs =
+            std::chrono::duration<double, std::milli>(end - start).count();
+
+        prefetcher.request(params);
+        while (!prefetcher.isReady())
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        start = std::chrono::steady_clock::now();
+        Level prefetched = prefetcher.take(params);
+        end = std::chrono::steady_clock::now();
+        double takeMs =
+            std::chrono::duration<double, std::milli>(end - start).count();
+
+        std::cout << "Next layer " << size << "x" << size << ": sync "
+                  << syncMs << " ms, prefetched " << takeMs << " ms"
+                  << std::endl;
+    }
+}
+
+/*
+ * Compares building a layer up front with building it in chunks
+ * The chunked layer is timed up to the first view around the start, then a
+ * walk across the map reads a 21x21 view at every step
+ */
+void benchChunked() {
+    int sizes[] = {1001, 4001, 16001};
+    for (int size : sizes) {
+        std::size_t base = bench_alloc::current();
+        bench_alloc::resetPeak();
+        auto start = std::chrono::steady_clock::now();
+        Level level = Level::chunked(size, Vector2D(0, 0), 40,
+                                     GeneratorType::Backtracker, 1340);
+        level.preload(Vector2D(0, 0), LevelPrefetcher::PRELOAD_RADIUS);
+        auto end = std::chrono::steady_clock::now();
+        double firstView =
+            std::chrono::duration<double, std::milli>(end - start).count();
+
+        int steps = 2000, stride = size / steps + 1, walls = 0;
+        start = std::chrono::steady_clock::now();
+        for (int step = 0; step < steps; step++) {
+            Vector2D pos(step * stride % size, step * stride % size);
+            level.preload(pos, LevelPrefetcher::PRELOAD_RADIUS);
+            for (int y = pos.y - 10; y <= pos.y + 10; y++)
+                for (int x = pos.x - 10; x <= pos.x + 10; x++)
+                    walls += level.getTile(Vector2D(y, x)) == TileObject::Wall;
+        }
+        end = std::chrono::steady_clock::now();
+        double walk =
+            std::chrono::duration<double, std::milli>(end - start).count();
+
+        std::cout << "Chunked " << size << "x" << size << ": first view "
+                  << firstView << " ms, " << steps << "-step walk " << walk
+                  << " ms, " << (bench_alloc::peak() - base) / 1024
+                  << " KiB peak (" << walls << " walls seen)" << std::endl;
+    }
+    std::cout << "Dense 4001x4001: " << timeLevel(4001) << " ms" << std::endl;
+}
+
+/*
+ * Times line of sight queries at every step of the path to the exit
+ * Casting should cost the same on any map size since only lit tiles are read,
+ * and a cached query should be a lookup
+ */
+void benchSight() {
+    int sizes[] = {101, 1001, 4001};
+    for (int size : sizes) {
+        Level level(size, Vector2D(0, 0), 4, 1340);
+        const std::vector<Vector2D> &path = level.getPathTiles();
+        int queries = std::min<int>(20000, int(path.size()));
+        FieldOfView fov;
+        long touched = 0, visible = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < queries; i++) {
+            visible += fov.get(level, path[i], 10).count();
+            touched += fov.getTouched();
+        }
+        auto end = std::chrono::steady_clock::now();
+        double cast =
+            std::chrono::duration<double, std::micro>(end - start).count();
+
+        int cached = 0;
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < queries; i++)
+            cached += fov.get(level, path[queries - 1], 10).count();
+        end = std::chrono::steady_clock::now();
+        double lookup =
+            std::chrono::duration<double, std::micro>(end - start).count();
+
+        std::cout << "Sight " << size << "x" << size << ": cast "
+                  << cast / queries << " us, cached " << lookup / queries
+                  << " us, " << double(visible) / queries << " visible / "
+                  << double(touched) / queries << " tiles read per query ("
+                  << cached / queries << " seen from the last tile)"
+                  << std::endl;
+    }
+}
+
+void runAll() {
+    std::cout << "Running Level benchmarks..." << std::endl;
+    benchGeneration();
+    benchGenerationModes();
+    benchMemory();
+    benchPrefetch();
+    benchChunked();
+    benchSight();
+    std::cout << "All Level benchmarks done!" << std::endl;
+}
+
+} // namespace level_bench
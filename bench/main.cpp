@@ -0,0 +1,75 @@
+#include "alloc.h"
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+#pragma region ALLOCATION COUNTER
+// Every block is prefixed with its size so delete can update the counters.
+// The counters are atomic since workers (e.g. the level prefetcher) allocate
+// at the same time as the main thread.
+static const std::size_t HEADER = 16;
+static std::atomic<std::size_t> allocCurrent(0), allocPeak(0), allocCount(0);
+
+void *operator new(std::size_t size) {
+    char *block = static_cast<char *>(std::malloc(size + HEADER));
+    if (block == nullptr)
+        throw std::bad_alloc();
+    *reinterpret_cast<std::size_t *>(block) = size;
+    std::size_t current = allocCurrent += size;
+    allocCount++;
+    // Raise the peak unless another thread already raised it past current
+    std::size_t peak = allocPeak.load();
+    while (current > peak && !allocPeak.compare_exchange_weak(peak, current))
+        ;
+    return block + HEADER;
+}
+
+void operator delete(void *ptr) noexcept {
+    if (ptr == nullptr)
+        return;
+    char *block = static_cast<char *>(ptr) - HEADER;
+    allocCurrent -= *reinterpret_cast<std::size_t *>(block);
+    std::free(block);
+}
+
+void *operator new[](std::size_t size) { return operator new(size); }
+void operator delete[](void *ptr) noexcept { operator delete(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { operator delete(ptr); }
+void operator delete[](void *ptr, std::size_t) noexcept {
+    operator delete(ptr);
+}
+
+std::size_t bench_alloc::current() { return allocCurrent; }
+std::size_t bench_alloc::peak() { return allocPeak; }
+void bench_alloc::resetPeak() { allocPeak = allocCurrent.load(); }
+std::size_t bench_alloc::count() { return allocCount; }
+#pragma endregion
+
+namespace level_bench {
+void runAll();
+}
+
+namespace display_bench {
+void runAll();
+}
+
+namespace generator_bench {
+void runAll();
+}
+
+namespace config_bench {
+void runAll();
+}
+
+int main() {
+    std::cout << "Running all benchmarks..." << std::endl;
+
+    level_bench::runAll();
+    display_bench::runAll();
+    generator_bench::runAll();
+    config_bench::runAll();
+
+    std::cout << "All benchmarks completed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,133 @@
+#include "include/chunkmap.h"
+#include "include/random.h"
+#include <algorithm>
+#include <cstring>
+
+/*
+ * Constructor for ChunkMap, no chunk is generated yet
+ * Prim's generators work on tiles instead of the cell lattice, so they are
+ * replaced by the recursive backtracker
+ *
+ * @param size      Size of the square maze
+ * @param type      Generator used to carve each chunk
+ * @param seed      Seed of the level
+ * @param maxChunks Number of chunks kept in memory, at least 1
+ * @return none
+ */
+ChunkMap::ChunkMap(int size, GeneratorType type, uint64_t seed, int maxChunks)
+    : size(size), chunksPerRow((size + CHUNK_SIZE - 1) / CHUNK_SIZE),
+      seed(seed), maxChunks(std::max(maxChunks, 1)), lastKey(-1),
+      lastChunk(nullptr), generated(0) {
+    if (type == GeneratorType::Prim || type == GeneratorType::PrimBitboard)
+        type = GeneratorType::Backtracker;
+    this->generator = MazeGenerator::create(type);
+}
+
+/*
+ * Gets a loaded chunk or generates it, evicting the least recently used
+ * chunk if the budget is full
+ *
+ * @param key Index of the chunk, row by row
+ * @return Chunk&
+ */
+ChunkMap::Chunk &ChunkMap::load(int key) {
+    std::unordered_map<int, Chunk>::iterator found = this->chunks.find(key);
+    if (found != this->chunks.end()) {
+        this->lru.splice(this->lru.begin(), this->lru, found->second.lruPos);
+    } else {
+        while (this->chunks.size() >= this->maxChunks) {
+            int oldest = this->lru.back();
+            this->lru.pop_back();
+            this->chunks.erase(oldest);
+            if (oldest == this->lastKey)
+                this->lastKey = -1;
+        }
+        found = this->chunks.insert(std::make_pair(key, Chunk())).first;
+        this->lru.push_front(key);
+        found->second.lruPos = this->lru.begin();
+        generateChunk(key, found->second);
+    }
+    this->lastKey = key;
+    this->lastChunk = &found->second;
+    return found->second;
+}
+
+/*
+ * Carves a chunk, opens its doors and replays its edits
+ *
+ * @param key   Index of the chunk, row by row
+ * @param chunk Chunk to fill
+ * @return void
+ */
+void ChunkMap::generateChunk(int key, Chunk &chunk) {
+    int top = key / this->chunksPerRow * CHUNK_SIZE;
+    int left = key % this->chunksPerRow * CHUNK_SIZE;
+    // Chunks with a neighbour below/right keep their last row/column as seam
+    bool seamBelow = top + CHUNK_SIZE < this->size;
+    bool seamRight = left + CHUNK_SIZE < this->size;
+    int height = seamBelow ? CHUNK_SIZE - 1 : this->size - top;
+    int width = seamRight ? CHUNK_SIZE - 1 : this->size - left;
+
+    Random rng(this->seed ^ (uint64_t(key) + 1) * 0xD1B54A32D192ED03ULL);
+    TileMap region(height, width, TileObject::Wall, TileObject::Border);
+    this->generator->generate(region, Vector2D(0, 0), rng);
+
+    chunk.tiles.assign(CHUNK_SIZE * CHUNK_SIZE, TileObject::Wall);
+    for (int y = 0; y < height; y++)
+        std::memcpy(&chunk.tiles[y * CHUNK_SIZE], region.row(y),
+                    width * sizeof(TileObject));
+
+    // Doors line up with a cell on both sides of the seam
+    if (seamRight) {
+        int y = 2 * rng.nextInt((height + 1) / 2);
+        chunk.tiles[y * CHUNK_SIZE + CHUNK_SIZE - 1] = TileObject::None;
+    }
+    if (seamBelow) {
+        int x = 2 * rng.nextInt((width + 1) / 2);
+        chunk.tiles[(CHUNK_SIZE - 1) * CHUNK_SIZE + x] = TileObject::None;
+    }
+
+    std::unordered_map<int, std::unordered_map<int, TileObject> >::iterator
+        log = this->edits.find(key);
+    if (log != this->edits.end())
+        for (const auto &edit : log->second)
+            chunk.tiles[edit.first] = edit.second;
+    this->generated++;
+}
+
+/*
+ * Sets a tile, the change outlives the eviction of its chunk
+ * Doesn't generate the chunk if it isn't loaded
+ *
+ * @param y    Row of the tile
+ * @param x    Column of the tile
+ * @param tile New tile
+ * @return void
+ */
+void ChunkMap::set(int y, int x, TileObject tile) {
+    if (y < 0 || x < 0 || y >= this->size || x >= this->size)
+        return;
+    int key = keyOf(y, x), local = localOf(y, x);
+    this->edits[key][local] = tile;
+    std::unordered_map<int, Chunk>::iterator found = this->chunks.find(key);
+    if (found != this->chunks.end())
+        found->second.tiles[local] = tile;
+}
+
+/*
+ * Loads every chunk that overlaps a square around a position, so they are
+ * ready before the view reaches them
+ *
+ * @param center Center of the square
+ * @param radius Distance from the center to the edges of the square
+ * @return void
+ */
+void ChunkMap::preload(Vector2D center, int radius) {
+    int top = std::max(center.y - radius, 0) / CHUNK_SIZE;
+    int bottom = std::min(center.y + radius, this->size - 1) / CHUNK_SIZE;
+    int left = std::max(center.x - radius, 0) / CHUNK_SIZE;
+    int right = std::min(center.x + radius, this->size - 1) / CHUNK_SIZE;
+    for (int cy = top; cy <= bottom; cy++)
+        for (int cx = left; cx <= right; cx++)
+            load(cy * this->chunksPerRow + cx);
+}
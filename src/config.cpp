@@ -1,7 +1,54 @@
 #include "include/config.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
 #include <fstream>
+#include <sstream>
 #include <stdlib.h>
 #include <sys/stat.h>
+#include <unistd.h>
+
+// How the value of a setting is parsed
+enum class SettingType { Key, Int, Bool, Text };
+
+// Name, default value & type of every setting, in the order of CONFIG_KEYS
+static const struct {
+    const char *name;
+    const char *fallback;
+    SettingType type;
+    const char *choices; // Values a Text setting may have, nullptr for any
+} SETTINGS[Config::KEY_COUNT] = {
+    {"KB_UP", "w", SettingType::Key, nullptr},
+    {"KB_DOWN", "s", SettingType::Key, nullptr},
+    {"KB_LEFT", "a", SettingType::Key, nullptr},
+    {"KB_RIGHT", "d", SettingType::Key, nullptr},
+    {"KB_CONFIRM", "f", SettingType::Key, nullptr},
+    {"KB_CANCEL", "x", SettingType::Key, nullptr},
+    {"KB_USE_PICKAXE", "e", SettingType::Key, nullptr},
+    {"KB_USE_RATION", "r", SettingType::Key, nullptr},
+    {"KB_EXIT", "q", SettingType::Key, nullptr},
+    {"KB_OVERLAY", "o", SettingType::Key, nullptr},
+    {"SEED", "0", SettingType::Int, nullptr},
+    {"THREADS", "1", SettingType::Int, nullptr},
+    {"RENDER_BACKEND", "curses", SettingType::Text, "curses framebuffer null"},
+    {"FRAME_CAP", "0", SettingType::Int, nullptr},
+    {"SHOW_INTRO", "true", SettingType::Bool, nullptr},
+};
+
+// Action of every key binding, in the order they are matched
+static const std::pair<Config::CONFIG_KEYS, KeyInput> BINDINGS[] = {
+    {Config::KB_UP, KeyInput::Up},
+    {Config::KB_DOWN, KeyInput::Down},
+    {Config::KB_LEFT, KeyInput::Left},
+    {Config::KB_RIGHT, KeyInput::Right},
+    {Config::KB_CONFIRM, KeyInput::Confirm},
+    {Config::KB_CANCEL, KeyInput::Cancel},
+    {Config::KB_USE_PICKAXE, KeyInput::UsePickaxe},
+    {Config::KB_USE_RATION, KeyInput::UseRation},
+    {Config::KB_EXIT, KeyInput::Exit},
+    {Config::KB_OVERLAY, KeyInput::ToggleOverlay},
+};
 
 /*
  * Config class constructor
@@ -37,14 +84,14 @@ Config::Config() {
     // Check if the config file exists
     std::ifstream file(configDir + CONFIG_FILE);
     if (!file.good()) {
-        // File does not exist, create it
-        std::ofstream newFile(configDir + CONFIG_FILE); // Create the file
-        newFile.close();                                // Close the file
-        createDefaultConfig();                          // Create default config
+        // File does not exist, create it with the default config
+        createDefaultConfig();
     } else {
         // File exists, do nothing
         file.close();
     }
+
+    load();
 }
 
 /*
@@ -55,46 +102,264 @@ Config::Config() {
 std::string Config::getConfigDir() { return configDir; }
 
 /*
- * Function to add a key-value pair to the configuration file
+ * Function to write the settings as the text of a configuration file
  *
- * Writes a key value pair in the form of KEY=VALUE in the configuration file
+ * Every setting is one KEY=VALUE line, in the order of CONFIG_KEYS
  *
- * @param key
- * @param value
+ * @return std::string
  */
-void Config::addPair(std::string key, std::string value) {
-    std::ofstream file(configDir + "config.txt", std::ios::app);
-    file << key << "=" << value << std::endl;
-    file.close();
+std::string Config::serialize() const {
+    std::string text;
+    for (int i = 0; i < KEY_COUNT; i++) {
+        text += SETTINGS[i].name;
+        text += '=';
+        text += this->settings[i].text;
+        text += '\n';
+    }
+    return text;
 }
 
 /*
- * Function to read a config pair from a given key
+ * Function to save the settings to the configuration file
  *
- * Returns a string which contains the value of the key value pair
+ * The whole file is built in memory and written to a temporary file in one
+ * go, which is flushed to disk and then renamed over the old file. A rename
+ * within a directory is atomic, so a crash leaves either the old file or the
+ * new one, never a torn file.
  *
- * @param key
- * @return std::string
+ * Usage:
+ * Config &config = Config::getShared();
+ * config.save();
+ *
+ * @return bool Whether the file was replaced
+ */
+bool Config::save() {
+    std::string text = serialize();
+    std::string path = configDir + CONFIG_FILE, temp = path + ".tmp";
+
+    int fd = open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        std::cerr << "Error writing config: " << temp << std::endl;
+        return false;
+    }
+    for (std::size_t done = 0; done < text.size();) {
+        ssize_t written = write(fd, text.data() + done, text.size() - done);
+        if (written > 0) {
+            done += std::size_t(written);
+        } else if (written < 0 && errno == EINTR) {
+            continue; // Interrupted before anything was written, try again
+        } else {
+            // An error, or a write that makes no progress and never would
+            std::cerr << "Error writing config: " << temp << std::endl;
+            close(fd);
+            unlink(temp.c_str());
+            return false;
+        }
+    }
+    bool ok = fsync(fd) == 0;
+    ok = close(fd) == 0 && ok;
+    if (!ok || rename(temp.c_str(), path.c_str()) != 0) {
+        std::cerr << "Error writing config: " << path << std::endl;
+        unlink(temp.c_str());
+        return false;
+    }
+
+    // The rename itself is only durable once the directory is flushed
+    int dir = open(configDir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dir >= 0) {
+        fsync(dir);
+        close(dir);
+    }
+    // The file now matches the settings, a watcher doesn't need to reload
+    this->source = text;
+    return true;
+}
+
+/*
+ * Function to parse the value of a setting into its type
+ *
+ * @param key     Setting the value is for
+ * @param text    Value as written in the file
+ * @param setting Where the parsed value goes, untouched if it is bad
+ * @return bool   False if the value doesn't fit the type of the setting
+ */
+bool Config::parse(CONFIG_KEYS key, const std::string &text,
+                   Setting &setting) {
+    Setting value;
+    value.text = text;
+    value.number = 0;
+    value.flag = false;
+
+    switch (SETTINGS[key].type) {
+    case SettingType::Key:
+        break;
+    case SettingType::Int: {
+        if (text.empty() || text[0] == '-')
+            return false;
+        char *end = nullptr;
+        value.number = strtoll(text.c_str(), &end, 10);
+        if (*end != '\0')
+            return false;
+        break;
+    }
+    case SettingType::Bool:
+        if (text == "true" || text == "1" || text == "yes" || text == "on")
+            value.flag = true;
+        else if (text != "false" && text != "0" && text != "no" &&
+                 text != "off")
+            return false;
+        break;
+    case SettingType::Text:
+        if (SETTINGS[key].choices != nullptr) {
+            // The value must be one of the words of the choices
+            std::string choices = std::string(" ") + SETTINGS[key].choices + " ";
+            if (text.empty() || text.find(' ') != std::string::npos ||
+                choices.find(" " + text + " ") == std::string::npos)
+                return false;
+        }
+        break;
+    }
+    setting = value;
+    return true;
+}
+
+/*
+ * Function to read the whole configuration file
+ *
+ * @return std::string Empty if the file can't be read
  */
-std::string Config::getPair(std::string key) {
+std::string Config::readFile() const {
     std::ifstream file(configDir + CONFIG_FILE);
+    std::ostringstream text;
+    text << file.rdbuf();
+    return text.str();
+}
 
+/*
+ * Function to parse the text of a configuration file into the settings
+ *
+ * Reads every KEY=VALUE pair once into the typed settings, then builds the
+ * keymap from the bindings, so nothing touches the file until the next load.
+ * When a key is bound twice, or a pair is in the file twice, the first one
+ * wins. Blank lines & lines starting with '#' are skipped.
+ *
+ * Everything is parsed on the side and swapped in at the end, so the
+ * settings are never half old & half new.
+ *
+ * @param text Contents of the configuration file
+ * @return void
+ */
+void Config::apply(const std::string &text) {
+    Setting parsed[KEY_COUNT];
+    std::vector<std::string> found;
+    for (int i = 0; i < KEY_COUNT; i++)
+        parse(CONFIG_KEYS(i), SETTINGS[i].fallback, parsed[i]);
+
+    bool seen[KEY_COUNT] = {};
+    std::istringstream file(text);
+    int number = 0;
     for (std::string line; std::getline(file, line);) {
-        if (line.find(key) != std::string::npos) {
-            return line.substr(line.find("=") + 1);
-            break;
+        number++;
+        if (!line.empty() && line[line.size() - 1] == '\r')
+            line.erase(line.size() - 1);
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        std::string where = CONFIG_FILE + ":" + std::to_string(number) + ": ";
+        std::size_t split = line.find("=");
+        if (split == std::string::npos) {
+            found.push_back(where + "not a KEY=VALUE pair");
+            continue;
+        }
+        std::string name = line.substr(0, split), value = line.substr(split + 1);
+        int key = 0;
+        while (key < KEY_COUNT && name != SETTINGS[key].name)
+            key++;
+        if (key == KEY_COUNT) {
+            found.push_back(where + "unknown key " + name);
+        } else if (seen[key]) {
+            found.push_back(where + name +
+                            " is set again, the first value is kept");
+        } else {
+            seen[key] = true;
+            if (!parse(CONFIG_KEYS(key), value, parsed[key]))
+                found.push_back(where + "bad value for " + name + ", using " +
+                                SETTINGS[key].fallback);
         }
     }
 
-    return std::string();
+    KeyInput bound[256];
+    for (int i = 0; i < 256; i++)
+        bound[i] = KeyInput::None;
+    for (const std::pair<CONFIG_KEYS, KeyInput> &binding : BINDINGS) {
+        const std::string &value = parsed[binding.first].text;
+        if (value.empty())
+            continue;
+        unsigned char key = value[0];
+        if (bound[key] == KeyInput::None)
+            bound[key] = binding.second;
+    }
+
+    for (int i = 0; i < KEY_COUNT; i++)
+        std::swap(this->settings[i], parsed[i]);
+    this->problems.swap(found);
+    std::copy(bound, bound + 256, this->keymap);
+    this->source = text;
 }
 
+/*
+ * Function to read the configuration file into memory
+ *
+ * @return void
+ */
+void Config::load() { apply(readFile()); }
+
+/*
+ * Function to read the configuration file again, e.g. after it was edited
+ *
+ * @return void
+ */
+void Config::reload() { load(); }
+
+/*
+ * Function to read the configuration file again only if its contents
+ * changed since the last load, e.g. when a watcher saw it being written
+ *
+ * @return bool Whether the settings were replaced
+ */
+bool Config::reloadIfChanged() {
+    std::string text = readFile();
+    if (text == this->source)
+        return false;
+    apply(text);
+    return true;
+}
+
+/*
+ * Function to get the config every part of the game shares
+ * It is loaded the first time it is needed.
+ *
+ * @return Config&
+ */
+Config &Config::getShared() {
+    static Config shared;
+    return shared;
+}
+
+/*
+ * Function to get the name of a setting as it is written in the file
+ *
+ * @param key
+ * @return const char*
+ */
+const char *Config::getName(CONFIG_KEYS key) { return SETTINGS[key].name; }
+
 /*
  * Function to create the default configuration
  *
  * Initializes default key bindings for core actions (movement, tools, quit).
  * This is used when there is no existing config file and we need to set up
- * the game with a standard control scheme.
+ * the game with a standard control scheme. The file is written in one save.
  *
  * Usage:
  * Config config;
@@ -110,19 +375,13 @@ std::string Config::getPair(std::string key) {
  * - Use Pickaxe   -> "e"
  * - Use Ration    -> "r"
  * - Exit Game     -> "q"
+ * - Perf Overlay  -> "o"
  *
  * @return void
  */
 void Config::createDefaultConfig() {
-    addPair(getConfigKeys.at(CONFIG_KEYS::KB_DOWN), "s");
-    addPair(getConfigKeys.at(CONFIG_KEYS::KB_UP), "w");
-    addPair(getConfigKeys.at(CONFIG_KEYS::KB_LEFT), "a");
-    addPair(getConfigKeys.at(CONFIG_KEYS::KB_RIGHT), "d");
-    addPair(getConfigKeys.at(CONFIG_KEYS::KB_CONFIRM), "f");
-    addPair(getConfigKeys.at(CONFIG_KEYS::KB_CANCEL), "x");
-    addPair(getConfigKeys.at(CONFIG_KEYS::KB_USE_PICKAXE), "e");
-    addPair(getConfigKeys.at(CONFIG_KEYS::KB_USE_RATION), "r");
-    addPair(getConfigKeys.at(CONFIG_KEYS::KB_EXIT), "q");
+    apply(""); // Every setting at its default
+    save();
 }
 
 /*
@@ -137,6 +396,4 @@ void Config::createDefaultConfig() {
  * @param key
  * @return std::string
  */
-std::string Config::getConfig(CONFIG_KEYS key) {
-    return getPair(getConfigKeys.at(key));
-}
+std::string Config::getConfig(CONFIG_KEYS key) { return getString(key); }
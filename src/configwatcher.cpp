@@ -0,0 +1,73 @@
+#include "include/configwatcher.h"
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+/*
+ * Constructor for ConfigWatcher
+ * Starts watching the directory of the file
+ *
+ * @param path Path of the file to watch
+ * @return none
+ */
+ConfigWatcher::ConfigWatcher(const std::string &path) : fd(-1), watch(-1) {
+    std::size_t slash = path.rfind('/');
+    std::string dir = slash == std::string::npos ? "." : path.substr(0, slash);
+    this->name = slash == std::string::npos ? path : path.substr(slash + 1);
+    if (dir.empty())
+        dir = "/";
+#ifdef __linux__
+    this->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (this->fd < 0)
+        return;
+    // Writes that finished & files renamed or moved into the directory
+    this->watch =
+        inotify_add_watch(this->fd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (this->watch < 0) {
+        close(this->fd);
+        this->fd = -1;
+    }
+#endif
+}
+
+/*
+ * Destructor for ConfigWatcher
+ *
+ * @return none
+ */
+ConfigWatcher::~ConfigWatcher() {
+#ifdef __linux__
+    if (this->fd >= 0)
+        close(this->fd);
+#endif
+}
+
+/*
+ * Drains the queued events without waiting for new ones
+ *
+ * @return bool Whether the file was written or replaced since the last poll
+ */
+bool ConfigWatcher::poll() {
+    bool changed = false;
+#ifdef __linux__
+    if (this->fd < 0)
+        return false;
+    // Aligned for the events, big enough for many of them
+    alignas(struct inotify_event) char buffer[4096];
+    for (;;) {
+        ssize_t length = read(this->fd, buffer, sizeof(buffer));
+        if (length <= 0)
+            break;
+        for (ssize_t offset = 0; offset < length;) {
+            const struct inotify_event *event =
+                reinterpret_cast<const struct inotify_event *>(buffer + offset);
+            if (event->len > 0 && this->name == event->name)
+                changed = true;
+            offset += sizeof(struct inotify_event) + event->len;
+        }
+    }
+#endif
+    return changed;
+}
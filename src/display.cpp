@@ -1,10 +1,17 @@
 #include "include/display.h"
 #include "include/enums.h"
+#include "include/fovmask.h"
 #include "include/item.h"
 #include "include/level.h"
+#include "include/profiler.h"
+#include "include/renderer.h"
+#include "include/screenbuffer.h"
 #include "include/vector2d.h"
+#include <algorithm>
+#include <chrono>
 #include <assert.h>
 #include <cmath>
+#include <cstdio>
 #include <ncurses.h>
 #include <sstream>
 #include <string.h>
@@ -13,6 +20,11 @@
 #define MEGAPIXEL "  "
 #define FOG "::"
 
+// Every frame is drawn here, then present() sends the changes to the renderer
+static ScreenBuffer screen;
+static std::unique_ptr<Renderer> renderer =
+    Renderer::create(RendererType::Curses);
+
 /*
  * Initializes the ncurses library and sets up color pairs for display
  *
@@ -39,17 +51,88 @@ void Display::initCurses() {
     init_pair(6, COLOR_WHITE, COLOR_BLACK);   // Fog
     init_pair(7, COLOR_WHITE, COLOR_BLACK);   // Text
     init_pair(8, COLOR_MAGENTA, COLOR_BLACK); // HUD text
+
+    // The terminal was just (re)initialized, repaint everything
+    setRenderer(Renderer::create(RendererType::Curses));
+}
+
+/*
+ * Changes where frames are sent, the next frame repaints every cell
+ *
+ * Usage:
+ * Display::setRenderer(Renderer::create(RendererType::Null, 40, 120));
+ *
+ * @param backend Renderer to use from now on
+ * @return void
+ */
+void Display::setRenderer(std::unique_ptr<Renderer> backend) {
+    renderer = std::move(backend);
+    screen.resize(renderer->getHeight(), renderer->getWidth());
 }
 
 /*
- * Clears and refreshes the screen
+ * Gets the renderer frames are sent to
+ * @return Renderer&
+ */
+Renderer &Display::getRenderer() { return *renderer; }
+
+/*
+ * Starts a new frame: blanks the back buffer and follows the screen size
+ * Nothing is sent to the renderer, so the screen doesn't flicker
  * @return void
  */
 void Display::flush() {
-    clear();
-    refresh();
+    PROFILE_BEGIN_FRAME();
+    int maxY = renderer->getHeight(), maxX = renderer->getWidth();
+    if (maxY != screen.getHeight() || maxX != screen.getWidth())
+        screen.resize(maxY, maxX);
+    else
+        screen.erase();
 }
 
+// Most frames per second isFrameDue allows, 0 = no cap
+static int frameCap = 0;
+static std::chrono::steady_clock::time_point lastPresent;
+
+/*
+ * Sends the cells that changed since the last frame to the renderer
+ * @return void
+ */
+void Display::present() {
+    {
+        PROFILE_SCOPE(Profiler::Present);
+        screen.present(*renderer);
+    }
+    lastPresent = std::chrono::steady_clock::now();
+    PROFILE_COUNT(Profiler::CellsSent, screen.getLastFrame().cells);
+    PROFILE_END_FRAME();
+}
+
+/*
+ * Sets the most frames per second to present when frames can be skipped
+ * @param fps Frames per second, 0 for no cap
+ * @return void
+ */
+void Display::setFrameCap(int fps) { frameCap = std::max(0, fps); }
+
+/*
+ * Checks if enough time has passed since the last present for the frame cap
+ * A frame that isn't due can be skipped, its changes go out with the next.
+ * @return bool Always true without a cap
+ */
+bool Display::isFrameDue() {
+    if (frameCap <= 0)
+        return true;
+    return std::chrono::steady_clock::now() - lastPresent >=
+           std::chrono::microseconds(1000000 / frameCap);
+}
+
+/*
+ * Gets the back buffer everything is drawn into
+ * @return ScreenBuffer&
+ */
+ScreenBuffer &Display::getScreen() { return screen; }
+
 /*
  * Maps a TileObject to a string representation
  * @param tile TileObject enum
@@ -60,6 +143,7 @@ std::string getTileChar(TileObject tile) {
     case TileObject::Player:
         return "P1";
     case TileObject::Wall:
+    case TileObject::Border:
         return "##";
     case TileObject::None:
         return "__";
@@ -89,7 +173,8 @@ int getTileColor(TileObject tile) {
     case TileObject::Player:
         return 1; // Player as Yellow
     case TileObject::Wall:
-        return 2; // Wall as White
+    case TileObject::Border:
+        return 2; // Wall & maze border as White
     case TileObject::None:
         return 3; // None as Black
     case TileObject::Exit:
@@ -118,161 +203,308 @@ int mapfov(int fov) {
 
 /*
  * Determines if a tile is within the player's visible radius
+ * Reads the precomputed mask of the radius, radii past FovMask::MAX_RADIUS
+ * use the same test without the table
  * @param y1,y2,x1,x2 tile and player positions
  * @param fov player's field of view
  * @return bool true if visible, false otherwise
  */
 bool isVisible(int y1, int x1, int y2, int x2, int fov) {
-    double dy = std::abs(y1 - y2), dx = std::abs(x1 - x2);
-    return std::round(std::sqrt(dy * dy + dx * dx)) <= fov;
+    int dy = y1 - y2, dx = x1 - x2;
+    if (fov < 0)
+        return false;
+    if (fov > FovMask::MAX_RADIUS)
+        return dy * dy + dx * dx <= fov * (fov + 1);
+    return FovMask::get(fov).contains(dy, dx);
 }
 
 #pragma region DRAW LEVEL HUD
+// Whether the performance overlay is drawn over the level HUD
+static bool overlayShown = false;
+
 /*
- * Draw a HUD with level data & background
- * @param player Player
- * @param currentLevel the number of levels completed - 1
+ * Draws the frame statistics of the profiler in the top left corner
+ * Values are averages of the last frames, counts are from the last frame
+ * @param level current Level object
+ * @return void
  */
-void drawLevelHUD(const Player &player, int currentLevel, std::string &text) {
+void drawOverlay(const Level &level) {
+    std::vector<std::string> lines;
+    if (!Profiler::isEnabled()) {
+        lines.push_back("Profiler compiled out");
+    } else {
+        char line[64];
+        snprintf(line, sizeof(line), "frame   %7.3f ms",
+                 Profiler::getAverage(Profiler::Frame));
+        lines.push_back(line);
+        snprintf(line, sizeof(line), "input   %7.3f ms to present",
+                 Profiler::getAverage(Profiler::Latency));
+        lines.push_back(line);
+        snprintf(line, sizeof(line), "draw    %7.3f ms, present %.3f ms",
+                 Profiler::getAverage(Profiler::Draw),
+                 Profiler::getAverage(Profiler::Present));
+        lines.push_back(line);
+        snprintf(line, sizeof(line), "layer   %7.1f ms to generate",
+                 level.getGenerationTime());
+        lines.push_back(line);
+        snprintf(line, sizeof(line), "%d tiles, %d cells, %d curses calls",
+                 Profiler::getCount(Profiler::TilesDrawn),
+                 Profiler::getCount(Profiler::CellsSent),
+                 Profiler::getCount(Profiler::CursesCalls));
+        lines.push_back(line);
+        snprintf(line, sizeof(line), "menu    %7.1f ms after start",
+                 Profiler::getAverage(Profiler::Startup));
+        lines.push_back(line);
+    }
+
+    screen.attrOn(COLOR_PAIR(8) | A_BOLD);
+    for (std::size_t i = 0; i < lines.size(); i++)
+        screen.mvAddStr(int(i), 0, lines[i].c_str());
+    screen.attrOff(COLOR_PAIR(8) | A_BOLD);
+}
+
+/*
+ * Draws the parts of the level HUD that don't change: the fog background,
+ * the border and the line under the stats
+ * @param layer Buffer to draw into, the size of the screen
+ * @return void
+ */
+static void drawHUDChrome(ScreenBuffer &layer) {
     int maxY, maxX;
-    getmaxyx(stdscr, maxY, maxX);
+    maxY = layer.getHeight();
+    maxX = layer.getWidth();
     int height = 27, width = 23;
     Vector2D anchor = Vector2D(int(maxY / 2) + 2, int(maxX / 2));
 
     // Draw background
-    attron(COLOR_PAIR(6) | A_DIM);
+    layer.attrOn(COLOR_PAIR(6) | A_DIM);
     for (int i = 0; i < 21; i++) {
-        move(anchor.y - 10 + i,
+        layer.move(anchor.y - 10 + i,
              anchor.x - 20); // Move one character right to avoid left border
         for (int j = 0; j < 21; j++) { // Reduced from 21 to 19 fog blocks
-            addstr(FOG);
+            layer.addStr(FOG);
         }
     }
-    attroff(COLOR_PAIR(6) | A_DIM);
+    layer.attrOff(COLOR_PAIR(6) | A_DIM);
 
-    // Rest of the function unchanged
     // Draw border
-    attron(A_BOLD);
-    attron(COLOR_PAIR(7));
+    layer.attrOn(A_BOLD);
+    layer.attrOn(COLOR_PAIR(7));
     // Left
     for (int i = 0; i < height; i++)
-        mvaddstr(anchor.y - 15 + i, anchor.x - 22, " |");
+        layer.mvAddStr(anchor.y - 15 + i, anchor.x - 22, " |");
 
     // Right
     for (int i = 0; i < height; i++)
-        mvaddstr(anchor.y - 15 + i, anchor.x + 22, "| ");
+        layer.mvAddStr(anchor.y - 15 + i, anchor.x + 22, "| ");
 
     // Top
-    move(anchor.y - 15, anchor.x - 22);
+    layer.move(anchor.y - 15, anchor.x - 22);
     for (int i = 0; i < width; i++)
-        addstr("--");
+        layer.addStr("--");
 
     // Middle
-    move(anchor.y - 11, anchor.x - 22);
+    layer.move(anchor.y - 11, anchor.x - 22);
     for (int i = 0; i < width; i++)
-        addstr("--");
+        layer.addStr("--");
 
     // Bottom
-    move(anchor.y + 11, anchor.x - 22);
+    layer.move(anchor.y + 11, anchor.x - 22);
     for (int i = 0; i < width; i++)
-        addstr("--");
+        layer.addStr("--");
 
     // 6 Corners
-    mvaddstr(anchor.y - 15, anchor.x - 22, " +");
-    mvaddstr(anchor.y - 15, anchor.x + 22, "+ ");
-    mvaddstr(anchor.y - 11, anchor.x - 22, " +");
-    mvaddstr(anchor.y - 11, anchor.x + 22, "+ ");
-    mvaddstr(anchor.y + 11, anchor.x - 22, " +");
-    mvaddstr(anchor.y + 11, anchor.x + 22, "+ ");
-
-    attroff(COLOR_PAIR(7));
-    attroff(A_BOLD);
-
-    std::string stamina = "SP: ", rations = "Rations: ",
-                pickaxes = "Pickaxes: ", level = "Layer ", line;
-    stamina.append(std::to_string(player.getStamina()));
-    stamina.append("/");
-    stamina.append(std::to_string(player.getStaminaMax()));
-
-    rations.append(std::to_string(player.getRationsOwned()));
-    rations.append("/");
-    rations.append(std::to_string(player.getRationCapacity()));
-
-    pickaxes.append(std::to_string(player.getPickaxesOwned()));
-    pickaxes.append("/");
-    pickaxes.append(std::to_string(player.getPickaxeCapacity()));
-
-    level.append(std::to_string(currentLevel));
-    if (!text.compare("Energy Drink"))
-        line.append("Consumed Energy Drink");
-    else {
-        line.append("Collected ");
-        line.append(text);
+    layer.mvAddStr(anchor.y - 15, anchor.x - 22, " +");
+    layer.mvAddStr(anchor.y - 15, anchor.x + 22, "+ ");
+    layer.mvAddStr(anchor.y - 11, anchor.x - 22, " +");
+    layer.mvAddStr(anchor.y - 11, anchor.x + 22, "+ ");
+    layer.mvAddStr(anchor.y + 11, anchor.x - 22, " +");
+    layer.mvAddStr(anchor.y + 11, anchor.x + 22, "+ ");
+
+    layer.attrOff(COLOR_PAIR(7));
+    layer.attrOff(A_BOLD);
+}
+
+/*
+ * Gets the HUD chrome as a layer the size of the screen
+ * It is only drawn again when the size of the screen changes.
+ * @return const ScreenBuffer&
+ */
+static const ScreenBuffer &getHUDLayer() {
+    static ScreenBuffer layer;
+    if (layer.getHeight() != screen.getHeight() ||
+        layer.getWidth() != screen.getWidth()) {
+        layer.resize(screen.getHeight(), screen.getWidth());
+        drawHUDChrome(layer);
     }
+    return layer;
+}
+
+/*
+ * Text of a HUD stat, only formatted again when one of its values changes
+ */
+struct HUDStat {
+    const char *format; // printf format of the two values
+    int value, max;
+    std::string text;
+
+    HUDStat(const char *format) : format(format), value(-1), max(-1) {}
+
+    /*
+     * @param value First value of the stat
+     * @param max   Second value of the stat, 0 if it only has one
+     * @return const std::string& The cached text
+     */
+    const std::string &get(int value, int max) {
+        if (value != this->value || max != this->max || this->text.empty()) {
+            char buffer[64];
+            snprintf(buffer, sizeof(buffer), this->format, value, max);
+            this->text = buffer;
+            this->value = value;
+            this->max = max;
+        }
+        return this->text;
+    }
+};
+
+/*
+ * Draw a HUD with level data & background
+ * The background & border come from the cached HUD layer that drawLevel
+ * starts the frame with, so only the stats are drawn here.
+ * @param layer current Level object
+ * @param player Player
+ * @param currentLevel the number of levels completed - 1
+ */
+void drawLevelHUD(const Level &layer, const Player &player, int currentLevel,
+                  std::string &text) {
+    int maxY, maxX;
+    maxY = screen.getHeight();
+    maxX = screen.getWidth();
+    Vector2D anchor = Vector2D(int(maxY / 2) + 2, int(maxX / 2));
 
-    attron(COLOR_PAIR(7));
-    mvaddstr(anchor.y - 14, anchor.x - 10 - int(level.size() / 2),
-             level.c_str());
-    mvaddstr(anchor.y - 14, anchor.x + 10 - int(pickaxes.size() / 2),
-             pickaxes.c_str());
-    mvaddstr(anchor.y - 13, anchor.x - 10 - int(stamina.size() / 2),
-             stamina.c_str());
-    mvaddstr(anchor.y - 13, anchor.x + 10 - int(rations.size() / 2),
-             rations.c_str());
-    attroff(COLOR_PAIR(7));
-
-    attron(COLOR_PAIR(1));
+    static HUDStat stamina("SP: %d/%d"), rations("Rations: %d/%d"),
+        pickaxes("Pickaxes: %d/%d"), level("Layer %d");
+    const std::string &staminaText =
+        stamina.get(player.getStamina(), player.getStaminaMax());
+    const std::string &rationsText =
+        rations.get(player.getRationsOwned(), player.getRationCapacity());
+    const std::string &pickaxesText =
+        pickaxes.get(player.getPickaxesOwned(), player.getPickaxeCapacity());
+    const std::string &levelText = level.get(currentLevel, 0);
+
+    screen.attrOn(COLOR_PAIR(7));
+    screen.mvAddStr(anchor.y - 14, anchor.x - 10 - int(levelText.size() / 2),
+             levelText.c_str());
+    screen.mvAddStr(anchor.y - 14,
+                    anchor.x + 10 - int(pickaxesText.size() / 2),
+                    pickaxesText.c_str());
+    screen.mvAddStr(anchor.y - 13, anchor.x - 10 - int(staminaText.size() / 2),
+             staminaText.c_str());
+    screen.mvAddStr(anchor.y - 13, anchor.x + 10 - int(rationsText.size() / 2),
+             rationsText.c_str());
+    screen.attrOff(COLOR_PAIR(7));
+
+    screen.attrOn(COLOR_PAIR(1));
     if (!text.empty()) {
-        mvaddstr(anchor.y - 12, anchor.x + 1 - int(line.size() / 2),
+        std::string line;
+        if (!text.compare("Energy Drink"))
+            line.append("Consumed Energy Drink");
+        else {
+            line.append("Collected ");
+            line.append(text);
+        }
+        screen.mvAddStr(anchor.y - 12, anchor.x + 1 - int(line.size() / 2),
                  line.c_str());
         text = "";
     }
-    attroff(COLOR_PAIR(1));
+    screen.attrOff(COLOR_PAIR(1));
+
+    if (overlayShown)
+        drawOverlay(layer);
 }
 
+/*
+ * Shows or hides the performance overlay of the level HUD
+ * @return void
+ */
+void Display::toggleOverlay() { overlayShown = !overlayShown; }
+
+bool Display::isOverlayShown() { return overlayShown; }
+
 /*
  * Draw a HUD behind the current screen
  * @return void
  */
 void drawHUD() {
     int maxY, maxX;
-    getmaxyx(stdscr, maxY, maxX);
+    maxY = screen.getHeight();
+    maxX = screen.getWidth();
     int height = 27, width = 23;
     Vector2D anchor = Vector2D(int(maxY / 2) + 2, int(maxX / 2));
 
     // Draw border
-    attron(A_BOLD);
-    attron(COLOR_PAIR(7));
+    screen.attrOn(A_BOLD);
+    screen.attrOn(COLOR_PAIR(7));
     // Left
     for (int i = 0; i < height; i++)
-        mvaddstr(anchor.y - 15 + i, anchor.x - 22, " |");
+        screen.mvAddStr(anchor.y - 15 + i, anchor.x - 22, " |");
 
     // Right
     for (int i = 0; i < height; i++)
-        mvaddstr(anchor.y - 15 + i, anchor.x + 22, "| ");
+        screen.mvAddStr(anchor.y - 15 + i, anchor.x + 22, "| ");
 
     // Top
-    move(anchor.y - 15, anchor.x - 22);
+    screen.move(anchor.y - 15, anchor.x - 22);
     for (int i = 0; i < width; i++)
-        addstr("--");
+        screen.addStr("--");
 
     // Bottom
-    move(anchor.y + 11, anchor.x - 22);
+    screen.move(anchor.y + 11, anchor.x - 22);
     for (int i = 0; i < width; i++)
-        addstr("--");
+        screen.addStr("--");
 
     // 4 Corners
-    mvaddstr(anchor.y - 15, anchor.x - 22, " +");
-    mvaddstr(anchor.y - 15, anchor.x + 22, "+ ");
-    mvaddstr(anchor.y + 11, anchor.x - 22, " +");
-    mvaddstr(anchor.y + 11, anchor.x + 22, "+ ");
+    screen.mvAddStr(anchor.y - 15, anchor.x - 22, " +");
+    screen.mvAddStr(anchor.y - 15, anchor.x + 22, "+ ");
+    screen.mvAddStr(anchor.y + 11, anchor.x - 22, " +");
+    screen.mvAddStr(anchor.y + 11, anchor.x + 22, "+ ");
 
-    attroff(COLOR_PAIR(7));
-    attroff(A_BOLD);
+    screen.attrOff(COLOR_PAIR(7));
+    screen.attrOff(A_BOLD);
 }
 #pragma endregion
 
 #pragma region DRAW LEVEL
+/*
+ * Gets the two screen cells a tile is drawn with, with their color pair
+ * The cells of every tile type are built the first time one is needed
+ *
+ * @param tile TileObject enum
+ * @return const chtype* The left & right cell
+ */
+static const chtype *getTileCells(TileObject tile) {
+    struct Table {
+        chtype cells[256][2];
+        Table() {
+            for (int i = 0; i < 256; i++) {
+                TileObject tile = static_cast<TileObject>(i);
+                // Walls, paths & the exit are blocks of color
+                std::string text = tile == TileObject::Wall ||
+                                           tile == TileObject::Border ||
+                                           tile == TileObject::None ||
+                                           tile == TileObject::Exit
+                                       ? MEGAPIXEL
+                                       : getTileChar(tile);
+                chtype color = COLOR_PAIR(getTileColor(tile));
+                cells[i][0] = chtype((unsigned char)text[0]) | color;
+                cells[i][1] = chtype((unsigned char)text[1]) | color;
+            }
+        }
+    };
+    static const Table table;
+    return table.cells[static_cast<unsigned char>(tile)];
+}
+
 /*
  * Renders the visible portion of the maze centered on the player
  * @param level current Level object
@@ -282,95 +514,71 @@ void drawHUD() {
 void Display::drawLevel(const Level &level, const Player &player,
                         int currentLevel, std::string &text,
                         KeyInput lastDirectionalInput) {
-    clear();
-    TileMap maze = level.getMaze();
+    PROFILE_SCOPE(Profiler::Draw);
+    // Starts from the HUD chrome instead of a blank frame
+    screen.erase(getHUDLayer());
     int size = level.getSize();
     int playerY = player.getPos().y, playerX = player.getPos().x;
-    int fov = player.getFov();
+    const FovMask &mask = FovMask::get(player.getFov());
+    bool seeAll = player.hasItem(ItemID::SunSeed);
+    // Line of sight shows the tiles walls don't hide past the radius
+    const Sight *sight = nullptr;
+    if (player.getSightMode() == SightMode::LineOfSight)
+        sight = &level.getSight(player.getPos(), player.getSightRange());
 
     int maxY, maxX;
-    getmaxyx(stdscr, maxY, maxX);
+    maxY = screen.getHeight();
+    maxX = screen.getWidth();
     // Initialize top left anchor to center
     Vector2D anchor = Vector2D(int(maxY / 2) + 2, int(maxX / 2));
 
-    auto isPerimeter = [](int y, int x, int size) {
-        return (y == -1 || x == -1 || y == size || x == size);
-    };
-
-    drawLevelHUD(player, currentLevel, text);
-
-    for (int i = -1; i <= size; i++) {
-        for (int j = -1; j <= size; j++) {
-            move(anchor.y + i - playerY, anchor.x + (j - playerX) * 2);
-            if (isVisible(i, j, playerY, playerX, fov) ||
-                player.hasItem(ItemID::SunSeed)) {
-                // Skip drawing if it's outside of HUD range
-                if (i <= playerY - 10 || j <= playerX - 10 ||
-                    j >= playerX + 10 || i >= playerY + 10) {
-                    continue;
-                }
-
-                // Calculate the screen coordinates before drawing
-                int screenY = anchor.y + i - playerY;
-                int screenX = anchor.x + (j - playerX) * 2;
-
-                // Skip drawing if we're at a border location
-                if (screenX == anchor.x - 20 || screenX == anchor.x + 20) {
-                    continue;
-                }
-
-                if (isPerimeter(i, j, size)) {
-                    // Tile inside FOV but is part of perimeter
-                    attron(COLOR_PAIR(2));
-                    addstr(MEGAPIXEL);
-                    attroff(COLOR_PAIR(2));
-                    continue;
-                }
-                // Tile is within the field of view & bounds of maze
-                int tile_color = getTileColor(maze[i][j]);
-
-                attron(COLOR_PAIR(tile_color));
-                if (maze[i][j] == TileObject::Wall ||
-                    maze[i][j] == TileObject::None ||
-                    maze[i][j] == TileObject::Exit) {
-                    addstr(MEGAPIXEL); // Print two spaces as a "block"
-                } else {
-                    std::string t = getTileChar(maze[i][j]);
-                    addstr(t.c_str());
-                }
-
-                attroff(COLOR_PAIR(tile_color));
-            } else {
-                // Tile Outside Field of view
-                if (i < playerY - 10 || j < playerX - 10 || j > playerX + 10 ||
-                    i > playerY + 10) {
-                    continue;
-                }
-
-                // Calculate the screen coordinates before drawing
-                int screenY = anchor.y + i - playerY;
-                int screenX = anchor.x + (j - playerX) * 2;
-
-                // Skip drawing fog if we're at a border location
-                if (screenX == anchor.x - 20 || screenX == anchor.x + 20) {
-                    continue;
-                }
-
-                move(screenY, screenX);
-                attron(COLOR_PAIR(6) | A_DIM);
-                addstr(FOG);
-                attroff(COLOR_PAIR(6) | A_DIM);
+    drawLevelHUD(level, player, currentLevel, text);
+
+    // Only the 21x21 window around the player is drawn, clipped to the maze &
+    // its border ring. The HUD border covers the left & right columns and the
+    // HUD background is the fog outside of the maze.
+    int top = std::max(-1, playerY - 10), bottom = std::min(size, playerY + 10);
+    int left = std::max(-1, playerX - 9), right = std::min(size, playerX + 9);
+    TileView window =
+        level.getView(top, left, bottom - top + 1, right - left + 1);
+    // Every row of the window is built as cells, then copied in one go
+    static const chtype fog[2] = {chtype(FOG[0]) | COLOR_PAIR(6) | A_DIM,
+                                  chtype(FOG[1]) | COLOR_PAIR(6) | A_DIM};
+    chtype cells[2 * 21];
+    int drawn = 0; // Visible tiles
+    for (int i = top; i <= bottom; i++) {
+        const TileObject *tiles = window.row(i - top);
+        // The top & bottom rows of the window are only drawn as fog, what is
+        // under their visible tiles is kept
+        bool edge = i == playerY - 10 || i == playerY + 10;
+        int y = anchor.y + i - playerY, x = anchor.x + (left - playerX) * 2;
+        int count = 0;
+        for (int j = left; j <= right; j++) {
+            int dy = i - playerY, dx = j - playerX;
+            bool visible = seeAll || mask.contains(dy, dx) ||
+                           (sight && sight->contains(dy, dx));
+            drawn += visible;
+            if (visible && edge) {
+                screen.putCells(y, x, cells, count);
+                x += count + 2;
+                count = 0;
+                continue;
             }
+            // The perimeter (-1 and size) is read from the border ring
+            const chtype *tile = visible ? getTileCells(tiles[j - left]) : fog;
+            cells[count++] = tile[0];
+            cells[count++] = tile[1];
         }
-        // printw("\n");
+        screen.putCells(y, x, cells, count);
     }
-    // attron(COLOR_PAIR(1));
+    PROFILE_COUNT(Profiler::TilesDrawn, drawn);
+    // screen.attrOn(COLOR_PAIR(1));
     // if(!player.hasItem(ItemID::TelescopeGlasses))
-    //     mvaddstr(anchor.y, anchor.x, "P1");
-    // attroff(COLOR_PAIR(1));
+    //     screen.mvAddStr(anchor.y, anchor.x, "P1");
+    // screen.attrOff(COLOR_PAIR(1));
 
     // Replace with:
-    attron(COLOR_PAIR(1));
+    screen.attrOn(COLOR_PAIR(1));
     if (!player.hasItem(ItemID::TelescopeGlasses)) {
         // Get character based on last direction
         std::string playerChar;
@@ -391,9 +599,9 @@ void Display::drawLevel(const Level &level, const Player &player,
             playerChar = "P1"; // Default if no direction set yet
             break;
         }
-        mvaddstr(anchor.y, anchor.x, playerChar.c_str());
+        screen.mvAddStr(anchor.y, anchor.x, playerChar.c_str());
     }
-    attroff(COLOR_PAIR(1));
+    screen.attrOff(COLOR_PAIR(1));
 }
 #pragma endregion
 
@@ -408,7 +616,8 @@ void Display::drawLevel(const Level &level, const Player &player,
 void drawMenu(std::vector<std::string> options, int highlighted, int dy = 0,
               int dx = 0) {
     int maxY, maxX;
-    getmaxyx(stdscr, maxY, maxX);
+    maxY = screen.getHeight();
+    maxX = screen.getWidth();
     // Initialize top left anchor to center
     Vector2D anchor = Vector2D(int(maxY / 2), int(maxX / 2));
     anchor.y -= int(options.size() / 2);
@@ -426,19 +635,18 @@ void drawMenu(std::vector<std::string> options, int highlighted, int dy = 0,
         int len = strlen(options[i].c_str());
         // Use visibleIndex for highlighting calculation instead
         if (visibleIndex == highlighted % options.size()) {
-            attron(COLOR_PAIR(7));
-            mvprintw(anchor.y + i, int(anchor.x - len / 2) + dx, "< %s >",
-                     options[i].c_str());
-            attroff(COLOR_PAIR(7));
+            screen.attrOn(COLOR_PAIR(7));
+            screen.mvAddStr(anchor.y + i, int(anchor.x - len / 2) + dx,
+                            ("< " + options[i] + " >").c_str());
+            screen.attrOff(COLOR_PAIR(7));
         } else {
-            attron(COLOR_PAIR(5) | A_BOLD);
-            mvprintw(anchor.y + i, int(anchor.x - len / 2) + dx, " <%s> ",
-                     options[i].c_str());
-            attroff(COLOR_PAIR(5) | A_BOLD);
+            screen.attrOn(COLOR_PAIR(5) | A_BOLD);
+            screen.mvAddStr(anchor.y + i, int(anchor.x - len / 2) + dx,
+                            (" <" + options[i] + "> ").c_str());
+            screen.attrOff(COLOR_PAIR(5) | A_BOLD);
         }
         visibleIndex++;
     }
-    refresh();
 }
 #pragma endregion
 
@@ -499,7 +707,8 @@ void Display::drawHelpMenu(int highlighted) {
     drawHUD();
 
     int maxY, maxX;
-    getmaxyx(stdscr, maxY, maxX);
+    maxY = screen.getHeight();
+    maxX = screen.getWidth();
     // Initialize top left anchor to center
     Vector2D anchor = Vector2D(int(maxY / 2), int(maxX / 2));
 
@@ -516,14 +725,15 @@ void Display::drawHelpMenu(int highlighted) {
 
     anchor.y -= int(text.size() / 2);
 
-    attron(COLOR_PAIR(7) | A_ITALIC);
+    screen.attrOn(COLOR_PAIR(7) | A_ITALIC);
     for (int i = 0; i < text.size(); i++) {
         int len = strlen(text[i].c_str());
         // Use visibleIndex for highlighting calculation instead
 
-        mvprintw(anchor.y + i, int(anchor.x - len / 2), " %s", text[i].c_str());
+        screen.mvAddStr(anchor.y + i, int(anchor.x - len / 2),
+                        (" " + text[i]).c_str());
     }
-    attroff(COLOR_PAIR(7) | A_ITALIC);
+    screen.attrOff(COLOR_PAIR(7) | A_ITALIC);
 
     std::vector<std::string> options = {"Back"};
 
@@ -556,7 +766,8 @@ void Display::drawInventoryMenu(
 void Display::drawItemMenu(int highlighted, std::string desc) {
     drawHUD();
     int maxY, maxX;
-    getmaxyx(stdscr, maxY, maxX);
+    maxY = screen.getHeight();
+    maxX = screen.getWidth();
     // Initialize top left anchor to center
     Vector2D anchor = Vector2D(int(maxY / 2) - 1, int(maxX / 2));
     std::stringstream ss(desc);
@@ -566,139 +777,185 @@ void Display::drawItemMenu(int highlighted, std::string desc) {
         lines.push_back(line);
 
     int dy = lines.size(), len;
-    attron(COLOR_PAIR(5));
+    screen.attrOn(COLOR_PAIR(5));
     for (int i = 0; i < dy; i++) {
         len = strlen(lines[i].c_str());
-        mvprintw(anchor.y - dy + i, int(anchor.x - len / 2), "%s",
-                 lines[i].c_str());
+        screen.mvAddStr(anchor.y - dy + i, int(anchor.x - len / 2),
+                        lines[i].c_str());
     }
 
-    attroff(COLOR_PAIR(5));
+    screen.attrOff(COLOR_PAIR(5));
     std::vector<std::string> options = {"Discard", "Back"};
     drawMenu(options, highlighted, 2);
 }
 
 #pragma region DRAW ANIMATION
 
+static const std::string CREDIT = "Presented by Group 137...";
+static const std::vector<std::string> TITLE = {
+    "       HH   HH  EEEEEEE  LL       LL       ",
+    "       HH   HH  EE       LL       LL       ",
+    "       HHHHHHH  EEEEE    LL       LL       ",
+    "       HH   HH  EE       LL       LL       ",
+    "       HH   HH  EEEEEEE  LLLLLLL  LLLLLLL  ",
+};
+static const int TITLE_WIDTH = 52; // Width the title is centered in
+
+// Part of the intro timeline, each of its steps is shown for a few ticks
+struct IntroPhase {
+    enum Kind { Credit, CreditHold, Pause, Bars, Scan, Expand, Hold } kind;
+    int steps;
+    int ticksPerStep;
+};
+
 /*
- * Displays the intro screen
- * @return void
+ * Gets the phases of the intro, the bars grow one column per step on each
+ * side so their length depends on the width of the screen
+ * @return std::vector<IntroPhase>
  */
-void Display::drawIntro() {
-    wclear(stdscr);
-    wrefresh(stdscr);
-    drawScrollingText("Presented by Group 137...                   ",
-                      std::make_pair(0, 0));
-    usleep(500000);
-
-    std::vector<std::string> title = {
-        "       HH   HH  EEEEEEE  LL       LL       \n",
-        "       HH   HH  EE       LL       LL       \n",
-        "       HHHHHHH  EEEEE    LL       LL       \n",
-        "       HH   HH  EE       LL       LL       \n",
-        "       HH   HH  EEEEEEE  LLLLLLL  LLLLLLL  \n",
-    };
+static std::vector<IntroPhase> getIntroPhases() {
+    int barSteps = screen.getWidth() / 2 + screen.getWidth() % 2;
+    return {{IntroPhase::Credit, int(CREDIT.size()), 10},
+            {IntroPhase::CreditHold, 1, 50},
+            {IntroPhase::Pause, 1, 50},
+            {IntroPhase::Bars, barSteps, 2},
+            {IntroPhase::Scan, TITLE_WIDTH / 2 - 2, 5},
+            {IntroPhase::Expand, TITLE_WIDTH / 2 - 3, 5},
+            {IntroPhase::Hold, 1, 50}};
+}
 
-    int y_max, x_max;
-    getmaxyx(stdscr, y_max, x_max);
-    int start_y = (y_max - 10) / 2;
-    int x_len = x_max / 2;
-    int x_mod = x_max % 2;
+/*
+ * Draws the columns [first, last] of the title
+ * @return void
+ */
+static void drawTitleColumns(int top, int left, int first, int last) {
+    for (int y = 0; y < int(TITLE.size()); y++)
+        for (int x = std::max(0, first);
+             x <= last && x < int(TITLE[y].size()); x++)
+            screen.mvAddStr(top + y, left + x, TITLE[y].substr(x, 1).c_str());
+}
 
-    WINDOW *title_pad = newpad(9, 52);
-    WINDOW *line_pad = newpad(2, x_len * 2 + x_mod);
-    waddstr(line_pad, std::string(x_len * 2 + x_mod, '=').c_str());
-    wattr_on(line_pad, COLOR_PAIR(6), nullptr);
+/*
+ * Gets the number of ticks the intro lasts on the current screen
+ * @return int
+ */
+int Display::getIntroTicks() {
+    int ticks = 0;
+    for (const IntroPhase &phase : getIntroPhases())
+        ticks += phase.steps * phase.ticksPerStep;
+    return ticks;
+}
 
-    for (const auto &row : title) {
-        waddstr(title_pad, row.c_str());
-        wattr_on(title_pad, COLOR_PAIR(6), nullptr);
+/*
+ * Draws one frame of the intro, the frame only depends on the tick so any
+ * tick can be drawn, in any order
+ * @param tick Number of INTRO_TICK_MS since the intro started
+ * @return bool false once the intro is over, nothing is drawn then
+ */
+bool Display::drawIntroFrame(int tick) {
+    std::vector<IntroPhase> phases = getIntroPhases();
+    std::size_t index = 0;
+    while (index < phases.size() &&
+           tick >= phases[index].steps * phases[index].ticksPerStep) {
+        tick -= phases[index].steps * phases[index].ticksPerStep;
+        index++;
     }
-
-    // Draw bars
-    for (int i = 0; i < x_len + x_mod; i++) {
-        prefresh(line_pad, 0, x_len - (i + 1) + x_mod, start_y,
-                 x_len - (i + 1) + x_mod, start_y, x_len + i);
-        prefresh(line_pad, 0, x_len - (i + 1) + x_mod, start_y + 9,
-                 x_len - (i + 1) + x_mod, start_y + 9, x_len + i);
-        usleep(20000);
+    if (index == phases.size())
+        return false;
+    IntroPhase phase = phases[index];
+    int step = tick / phase.ticksPerStep;
+
+    int maxY = screen.getHeight(), maxX = screen.getWidth();
+    int startY = (maxY - 10) / 2;
+    int half = maxX / 2, odd = maxX % 2;
+    int titleX = (maxX - TITLE_WIDTH) / 2;
+
+    if (phase.kind == IntroPhase::Credit) {
+        drawScrollingText(CREDIT, {0, 0}, step + 1);
+        return true;
     }
-
-    WINDOW *logo_subwin = subwin(stdscr, 8, x_max, start_y + 1, 0);
-
-    // Draw scanning effect
-    int x_shift = (x_max - 52) / 2;
-    for (int i = 0; i < 52 / 2 - 2; i++) {
-        wclear(logo_subwin);
-        wrefresh(logo_subwin);
-        prefresh(title_pad, 0, i, start_y + 2, x_shift + i, start_y + 8,
-                 x_shift + i);
-        prefresh(title_pad, 0, 51 - i, start_y + 2, x_shift + 51 - i,
-                 start_y + 8, x_shift + 51 - i);
-        usleep(50000);
+    if (phase.kind == IntroPhase::CreditHold) {
+        drawScrollingText(CREDIT, {0, 0}, int(CREDIT.size()));
+        return true;
     }
+    if (phase.kind == IntroPhase::Pause)
+        return true;
+
+    // The two bars grow from the middle, then stay
+    int barStep = phase.kind == IntroPhase::Bars ? step : half + odd - 1;
+    std::string bar(2 * barStep + 2 - odd, '=');
+    screen.mvAddStr(startY, half - (barStep + 1) + odd, bar.c_str());
+    screen.mvAddStr(startY + 9, half - (barStep + 1) + odd, bar.c_str());
+
+    if (phase.kind == IntroPhase::Scan) {
+        // Two columns sweep in from the edges of the title
+        drawTitleColumns(startY + 2, titleX, step, step);
+        drawTitleColumns(startY + 2, titleX, TITLE_WIDTH - 1 - step,
+                         TITLE_WIDTH - 1 - step);
+    } else if (phase.kind == IntroPhase::Expand) {
+        // Then the title opens up from its middle
+        int i = step + 3;
+        drawTitleColumns(startY + 2, titleX, TITLE_WIDTH / 2 - (i + 1),
+                         TITLE_WIDTH / 2 + i);
+    } else if (phase.kind == IntroPhase::Hold) {
+        drawTitleColumns(startY + 2, titleX, 0, TITLE_WIDTH - 1);
+    }
+    return true;
+}
 
-    // Draw logo expansion
-    for (int i = 3; i < 52 / 2; i++) {
-        prefresh(title_pad, 0, 52 / 2 - (i + 1), start_y + 2,
-                 x_shift + 52 / 2 - (i + 1), start_y + 8, x_shift + 52 / 2 + i);
-        usleep(50000);
+/*
+ * Plays the intro, one frame per tick, until it ends or a key is pressed
+ * The frame shown follows the time since the start, so a slow terminal
+ * drops frames instead of making the intro longer
+ * @return void
+ */
+void Display::drawIntro() {
+    auto start = std::chrono::steady_clock::now();
+    timeout(INTRO_TICK_MS); // getch waits for at most one tick
+    int tick = 0;
+    while (true) {
+        flush();
+        if (!drawIntroFrame(tick))
+            break;
+        present();
+        if (getch() != ERR) // Any key skips the rest
+            break;
+        tick = int(std::chrono::duration_cast<std::chrono::milliseconds>(
+                       std::chrono::steady_clock::now() - start)
+                       .count() /
+                   INTRO_TICK_MS);
     }
-    usleep(500000);
+    timeout(-1);
     flushinp();
-    wclear(stdscr);
-    wrefresh(stdscr);
+    flush();
+    present();
 }
 
 /*
- * Displays scrolling text on the screen
+ * Draws text that is being revealed one character at a time
  * @param text string to be displayed
- * @param pos position of the text
- * @param updates number of updates per second
- * @param mirrored if true, text will scroll in reverse
- * @param flush_screen if true, clears the screen before displaying
+ * @param pos position of the middle of the text, {-1, -1} for the middle of
+ * the screen. The text is kept on screen if it would start left of it
+ * @param shown number of characters revealed so far
+ * @param mirrored if true, the revealed part slides in from the right end
  * @param bold if true, text will be bold
  * @return void
  */
 void Display::drawScrollingText(const std::string &text,
-                                std::pair<int, int> pos, int updates,
+                                std::pair<int, int> pos, int shown,
                                 bool mirrored, bool bold) {
-    int y_max, x_max;
-    getmaxyx(stdscr, y_max, x_max);
-
-    if (pos.first == -1 || pos.second == -1) {
-        pos = {y_max / 2, x_max / 2};
-    }
-
-    WINDOW *pad = newpad(10, 100);
-    int start_x = pos.second - text.length() / 2;
-    waddstr(pad, text.c_str());
-    if (bold) {
-        wattron(pad, COLOR_PAIR(6) | A_BOLD);
-    } else {
-        wattron(pad, COLOR_PAIR(6));
-    }
-
-    for (size_t i = 0; i < text.length(); i++) {
-        if (!mirrored) {
-            prefresh(pad, 0, 0, pos.first, start_x, pos.first, start_x + i);
-        } else {
-            prefresh(pad, 0, 0, pos.first, start_x + text.length() - i,
-                     pos.first, start_x + text.length());
-        }
-        usleep(1000000 / updates);
-    }
-
-    mvwaddstr(stdscr, pos.first, pos.second, text.c_str());
-    if (bold) {
-        wattron(stdscr, COLOR_PAIR(6) | A_BOLD);
-    } else {
-        wattron(stdscr, COLOR_PAIR(6));
-    }
-    flushinp();
-    usleep(500000);
-    wclear(stdscr);
-    wrefresh(stdscr);
+    if (pos.first == -1 || pos.second == -1)
+        pos = {screen.getHeight() / 2, screen.getWidth() / 2};
+    shown = std::max(0, std::min(shown, int(text.size())));
+
+    int startX = std::max(0, pos.second - int(text.size()) / 2);
+    if (mirrored)
+        startX += int(text.size()) - shown;
+
+    attr_t attrs = COLOR_PAIR(6) | (bold ? A_BOLD : 0);
+    screen.attrOn(attrs);
+    screen.mvAddStr(pos.first, startX, text.substr(0, shown).c_str());
+    screen.attrOff(attrs);
 }
 #pragma endregion
 
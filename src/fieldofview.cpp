@@ -0,0 +1,163 @@
+#include "include/fieldofview.h"
+#include "include/level.h"
+
+#include <cstdlib>
+
+/*
+ * Counts the visible tiles
+ *
+ * @return int
+ */
+int Sight::count() const {
+    int total = 0;
+    for (int i = 0; i <= 2 * MAX_RADIUS; i++)
+        total += __builtin_popcount(this->rows[i]);
+    return total;
+}
+
+/*
+ * Constructor for FieldOfView
+ * Starts with an empty cache
+ *
+ * @return none
+ */
+FieldOfView::FieldOfView() : computed(0), touched(0) {}
+
+/*
+ * Checks if a tile blocks sight, anything outside of the maze is the border
+ *
+ * @param level Level the tile is in
+ * @param pos   Position of the tile
+ * @return bool
+ */
+bool FieldOfView::isOpaque(const Level &level, Vector2D pos) {
+    this->touched++;
+    TileObject tile = level.getTile(pos);
+    return tile == TileObject::Wall || tile == TileObject::Border;
+}
+
+/*
+ * Scans one octant from a row outwards, between two slopes
+ * The octant is mapped to the grid by (xx, xy, yx, yy), so the same scan
+ * works for all 8 of them. When a wall ends a lit run, the rest of the run
+ * is scanned by a recursive call and this scan goes on past the wall.
+ *
+ * @param level  Level to look through
+ * @param sight  Sight the visible tiles are marked in
+ * @param row    Distance from the origin of the first row to scan
+ * @param start  Slope of the lit arc on the start side, starts at 1
+ * @param end    Slope of the lit arc on the end side, starts at 0
+ * @param xx, xy, yx, yy Transform from octant to grid offsets
+ * @return void
+ */
+void FieldOfView::castOctant(const Level &level, Sight &sight, int row,
+                             double start, double end, int xx, int xy, int yx,
+                             int yy) {
+    if (start < end)
+        return;
+    const FovMask &mask = FovMask::get(sight.radius);
+    Vector2D origin = sight.origin;
+    double nextStart = start;
+    for (int depth = row; depth <= sight.radius; depth++) {
+        bool blocked = false;
+        for (int dx = -depth, dy = -depth; dx <= 0; dx++) {
+            // Slopes of the left & right edges of the tile
+            double leftSlope = (dx - 0.5) / (dy + 0.5);
+            double rightSlope = (dx + 0.5) / (dy - 0.5);
+            if (start < rightSlope)
+                continue;
+            if (end > leftSlope)
+                break;
+
+            int offsetY = dx * yx + dy * yy, offsetX = dx * xx + dy * xy;
+            if (mask.contains(offsetY, offsetX))
+                sight.mark(offsetY, offsetX);
+
+            bool opaque = isOpaque(
+                level, Vector2D(origin.y + offsetY, origin.x + offsetX));
+            if (blocked) {
+                if (opaque) {
+                    nextStart = rightSlope;
+                    continue;
+                }
+                blocked = false;
+                start = nextStart;
+            } else if (opaque && depth < sight.radius) {
+                blocked = true;
+                castOctant(level, sight, depth + 1, start, leftSlope, xx, xy,
+                           yx, yy);
+                nextStart = rightSlope;
+            }
+        }
+        if (blocked)
+            break;
+    }
+}
+
+/*
+ * Gets the tiles seen from a position, casting them if they aren't cached
+ * The reference stays valid until the cache is invalidated or cleared.
+ *
+ * @param level  Level to look through
+ * @param origin Position to look from
+ * @param radius How far sight reaches, clamped to 0..Sight::MAX_RADIUS
+ * @return const Sight&
+ */
+const Sight &FieldOfView::get(const Level &level, Vector2D origin,
+                              int radius) {
+    if (radius < 0)
+        radius = 0;
+    if (radius > Sight::MAX_RADIUS)
+        radius = Sight::MAX_RADIUS;
+    // Positions are inside the maze, so y & x fit in 28 & 32 bits
+    uint64_t key = uint64_t(uint32_t(origin.y)) << 36 |
+                   uint64_t(uint32_t(origin.x)) << 4 | uint64_t(radius);
+    std::unordered_map<uint64_t, Sight>::iterator found = this->cache.find(key);
+    if (found != this->cache.end())
+        return found->second;
+
+    if (int(this->cache.size()) >= MAX_ENTRIES)
+        this->cache.clear();
+    Sight &sight = this->cache[key];
+    sight.origin = origin;
+    sight.radius = radius;
+    sight.mark(0, 0);
+
+    static const int octants[8][4] = {{1, 0, 0, 1},  {0, 1, 1, 0},
+                                      {0, -1, 1, 0}, {-1, 0, 0, 1},
+                                      {-1, 0, 0, -1}, {0, -1, -1, 0},
+                                      {0, 1, -1, 0}, {1, 0, 0, -1}};
+    this->touched = 0;
+    for (int i = 0; i < 8; i++)
+        castOctant(level, sight, 1, 1.0, 0.0, octants[i][0], octants[i][1],
+                   octants[i][2], octants[i][3]);
+    this->computed++;
+    return sight;
+}
+
+/*
+ * Drops the cached sights that could see a tile, call it when the tile
+ * starts or stops blocking sight
+ *
+ * @param pos Position of the tile that changed
+ * @return void
+ */
+void FieldOfView::invalidate(Vector2D pos) {
+    std::unordered_map<uint64_t, Sight>::iterator it = this->cache.begin();
+    while (it != this->cache.end()) {
+        Vector2D origin = it->second.origin;
+        int radius = it->second.radius;
+        if (std::abs(origin.y - pos.y) <= radius &&
+            std::abs(origin.x - pos.x) <= radius)
+            it = this->cache.erase(it);
+        else
+            ++it;
+    }
+}
+
+/*
+ * Drops every cached sight
+ *
+ * @return void
+ */
+void FieldOfView::clear() { this->cache.clear(); }
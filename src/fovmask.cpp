@@ -0,0 +1,40 @@
+#include "include/fovmask.h"
+
+/*
+ * Constructor for FovMask
+ * Finds how far each row of the circle reaches with integer math only
+ *
+ * @param radius Radius of the mask, from 0 to MAX_RADIUS
+ * @return none
+ */
+FovMask::FovMask(int radius) : radius(radius) {
+    int limit = radius * (radius + 1);
+    for (int dy = 0; dy <= MAX_RADIUS; dy++) {
+        int dx = -1;
+        while (dy <= radius && dy * dy + (dx + 1) * (dx + 1) <= limit)
+            dx++;
+        this->reach[dy] = dx;
+    }
+}
+
+/*
+ * Gets the mask of a radius
+ *
+ * @param radius Radius of the mask, clamped to 0..MAX_RADIUS
+ * @return const FovMask&
+ */
+const FovMask &FovMask::get(int radius) {
+    struct Table {
+        FovMask masks[MAX_RADIUS + 1];
+        Table() {
+            for (int r = 0; r <= MAX_RADIUS; r++)
+                masks[r] = FovMask(r);
+        }
+    };
+    static const Table table; // Built once, thread-safe since C++11
+    if (radius < 0)
+        radius = 0;
+    if (radius > MAX_RADIUS)
+        radius = MAX_RADIUS;
+    return table.masks[radius];
+}
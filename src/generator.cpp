@@ -0,0 +1,468 @@
+#include "include/generator.h"
+#include "include/bitboard.h"
+#include "include/enums.h"
+#include "include/mazestream.h"
+#include "include/utils.h"
+#include "include/vector2d.h"
+#include <algorithm>
+#include <vector>
+
+/*
+ * Creates a generator of the given type
+ *
+ * Usage:
+ * auto generator = MazeGenerator::create(GeneratorType::Wilson);
+ *
+ * @param type Algorithm to use
+ * @return std::unique_ptr<MazeGenerator> The generator
+ */
+std::unique_ptr<MazeGenerator> MazeGenerator::create(GeneratorType type) {
+    switch (type) {
+    case GeneratorType::PrimBitboard:
+        return utils::make_unique<PrimGenerator>(GenerationMode::Bitboard);
+    case GeneratorType::Backtracker:
+        return utils::make_unique<BacktrackerGenerator>();
+    case GeneratorType::Kruskal:
+        return utils::make_unique<KruskalGenerator>();
+    case GeneratorType::Wilson:
+        return utils::make_unique<WilsonGenerator>();
+    case GeneratorType::Eller:
+        return utils::make_unique<EllerGenerator>();
+    default:
+        return utils::make_unique<PrimGenerator>(GenerationMode::Scalar);
+    }
+}
+
+#pragma region PRIM
+/*
+ * Constructor for the Prim's generator
+ *
+ * @param mode How open tiles are tracked, both modes produce the same maze
+ * for the same seed
+ */
+PrimGenerator::PrimGenerator(GenerationMode mode)
+    : mode(mode), maze(nullptr), rng(nullptr), size(0) {}
+
+/*
+ * Carves a maze into the tile map with Prim's algorithm
+ *
+ * @param maze  Tile map filled with walls
+ * @param start Starting position of the generation
+ * @param rng   Source of randomness
+ * @return void
+ */
+void PrimGenerator::generate(TileMap &maze, Vector2D start, Random &rng) {
+    this->maze = &maze;
+    this->rng = &rng;
+    this->size = maze.getWidth();
+    if (this->mode == GenerationMode::Bitboard)
+        generateBitboard(start);
+    else
+        generateScalar(start);
+    this->maze = nullptr;
+    this->rng = nullptr;
+}
+
+const char *PrimGenerator::getName() const {
+    return this->mode == GenerationMode::Bitboard ? "Prim (bitboard)" : "Prim";
+}
+
+/*
+ * Function to generate a maze of pre-determined size with given starting point
+ * Uses Iterative Randomized Prim's Algorithm
+ *
+ * Args: starting position
+ */
+void PrimGenerator::generateScalar(Vector2D pos) {
+    this->queued = std::vector<bool>(this->maze->getHeight() * this->size, false);
+#pragma region Starting Cell
+    (*this->maze)(pos.y, pos.x) = TileObject::None;
+    getAdjWalls(pos);
+#pragma endregion
+
+    // While there are walls to be checked/removed, do Prim's algorithm
+    while (this->wallList.size() > 0) {
+        // Get random wall to verify
+        int index = this->rng->nextInt(int(this->wallList.size()));
+        pos = this->wallList[index];
+
+        // Check if chosen wall is connected to too many empty tiles
+        if (verifyWall(pos)) {
+            // Remove wall
+            (*this->maze)(pos.y, pos.x) = TileObject::None;
+            getAdjWalls(pos);
+        }
+
+        // Remove any checked wall from the list of unchecked walls
+        // Order of the list doesn't matter, so swap with the last wall & pop
+        // instead of erasing from the middle (O(1) instead of O(n))
+        this->wallList[index] = this->wallList.back();
+        this->wallList.pop_back();
+    }
+    // Generation is done, release the helper lists
+    std::vector<Vector2D>().swap(this->wallList);
+    std::vector<bool>().swap(this->queued);
+}
+
+/*
+ * Same algorithm as generateScalar, but open & queued tiles are kept as rows of
+ * 64-bit words instead of being read from the tile map
+ * Neighbour counts are one popcount over a merged 3-row window, and new
+ * frontier walls come from the same windows of both boards
+ * Walls are visited and queued in the same order as generateScalar, so the
+ * same seed gives the same maze
+ *
+ * Args: starting position
+ */
+void PrimGenerator::generateBitboard(Vector2D pos) {
+    BitBoard open(this->maze->getHeight(), this->size, false);
+    BitBoard queued(this->maze->getHeight(), this->size, true); // Border is never queued
+    // Offsets in the order used by getAdjWalls: up, left, down, right
+    const Vector2D dirs[] = {Vector2D(-1, 0), Vector2D(0, -1), Vector2D(1, 0),
+                             Vector2D(0, 1)};
+
+    auto queueAdjWalls = [&](Vector2D pos) {
+        int candidates = queued.clearAdjacent(open, pos.y, pos.x);
+        for (int i = 0; i < 4; i++) {
+            if (!(candidates >> i & 1))
+                continue;
+            Vector2D wall = pos + dirs[i];
+            queued.set(wall.y, wall.x);
+            this->wallList.push_back(wall);
+        }
+    };
+
+    open.set(pos.y, pos.x);
+    queueAdjWalls(pos);
+
+    while (this->wallList.size() > 0) {
+        int index = this->rng->nextInt(int(this->wallList.size()));
+        pos = this->wallList[index];
+
+        if (open.countAdjacent(pos.y, pos.x) == 1) {
+            open.set(pos.y, pos.x);
+            queueAdjWalls(pos);
+        }
+
+        this->wallList[index] = this->wallList.back();
+        this->wallList.pop_back();
+    }
+    std::vector<Vector2D>().swap(this->wallList);
+
+    // Copy the open tiles into the tile map a word at a time
+    TileMap &maze = *this->maze;
+    open.forEachSet([&maze](int y, int x) { maze(y, x) = TileObject::None; });
+}
+
+/*
+ * Function to add a wall to the list of walls
+ * Walls that have already been added once are skipped, since a wall that
+ * failed verification can never become removable again
+ *
+ * Args: position of the wall
+ */
+void PrimGenerator::queueWall(Vector2D pos) {
+    int index = pos.y * this->size + pos.x;
+    if (this->queued[index])
+        return;
+    this->queued[index] = true;
+    this->wallList.push_back(pos);
+}
+
+/*
+ * Function to find all walls next to given position
+ * Any wall found will be added to the list of walls
+ *
+ * Args: position to check
+ *
+ */
+void PrimGenerator::getAdjWalls(Vector2D pos) {
+    // The border ring is never a Wall, so no bounds checks are needed
+    // Check above
+    if ((*this->maze)(pos.y - 1, pos.x) == TileObject::Wall)
+        queueWall(Vector2D(pos.y - 1, pos.x));
+
+    // Check left
+    if ((*this->maze)(pos.y, pos.x - 1) == TileObject::Wall)
+        queueWall(Vector2D(pos.y, pos.x - 1));
+
+    // Check below
+    if ((*this->maze)(pos.y + 1, pos.x) == TileObject::Wall)
+        queueWall(Vector2D(pos.y + 1, pos.x));
+
+    // Check right
+    if ((*this->maze)(pos.y, pos.x + 1) == TileObject::Wall)
+        queueWall(Vector2D(pos.y, pos.x + 1));
+}
+
+/*
+ * Function to verify if a wall can be removed
+ * A wall can only be removed if it is connected to no more than 1 empty tiles
+ *
+ * Assumption: only walls next to at least one empty tile can exist in the list
+ * of walls
+ *
+ * Args: position of wall to verify
+ *
+ * Return: if the wall can be removed or not
+ */
+bool PrimGenerator::verifyWall(Vector2D wallPos) const {
+    // The border ring is never None, so no bounds checks are needed
+    int count = 0;
+    // Check up
+    if ((*this->maze)(wallPos.y - 1, wallPos.x) == TileObject::None)
+        count++;
+
+    // Check left
+    if ((*this->maze)(wallPos.y, wallPos.x - 1) == TileObject::None)
+        count++;
+
+    // Check down
+    if ((*this->maze)(wallPos.y + 1, wallPos.x) == TileObject::None)
+        count++;
+
+    // Check right
+    if ((*this->maze)(wallPos.y, wallPos.x + 1) == TileObject::None)
+        count++;
+
+    return count == 1;
+}
+
+#pragma endregion
+
+#pragma region CELL LATTICE
+/*
+ * Helper to map between the cells of the lattice and tiles of the map
+ * Cells are numbered row by row, cell 0 is the top left cell
+ */
+struct CellLattice {
+    int offsetY, offsetX; // Parity of the cell tiles
+    int rows, cols;
+
+    CellLattice(const TileMap &maze, Vector2D start)
+        : offsetY(start.y % 2), offsetX(start.x % 2),
+          rows((maze.getHeight() - start.y % 2 + 1) / 2),
+          cols((maze.getWidth() - start.x % 2 + 1) / 2) {}
+
+    inline int count() const { return this->rows * this->cols; }
+    inline int cellOf(Vector2D pos) const {
+        return (pos.y - offsetY) / 2 * cols + (pos.x - offsetX) / 2;
+    }
+    inline Vector2D tileOf(int cell) const {
+        return Vector2D(offsetY + cell / cols * 2, offsetX + cell % cols * 2);
+    }
+
+    /*
+     * Gets the cell next to the given cell
+     *
+     * @param cell Cell to move from
+     * @param dir  0 = up, 1 = left, 2 = down, 3 = right
+     * @return int The neighbouring cell, -1 if it is outside of the lattice
+     */
+    inline int neighbour(int cell, int dir) const {
+        int row = cell / cols, col = cell % cols;
+        switch (dir) {
+        case 0:
+            return row > 0 ? cell - cols : -1;
+        case 1:
+            return col > 0 ? cell - 1 : -1;
+        case 2:
+            return row < rows - 1 ? cell + cols : -1;
+        default:
+            return col < cols - 1 ? cell + 1 : -1;
+        }
+    }
+
+    // Opens a cell and the wall between it and a neighbouring cell
+    inline void carve(TileMap &maze, int from, int to) const {
+        Vector2D a = tileOf(from), b = tileOf(to);
+        maze(a.y, a.x) = TileObject::None;
+        maze((a.y + b.y) / 2, (a.x + b.x) / 2) = TileObject::None;
+        maze(b.y, b.x) = TileObject::None;
+    }
+};
+#pragma endregion
+
+#pragma region RECURSIVE BACKTRACKER
+/*
+ * Carves a maze with a depth-first search
+ * The recursion is replaced by an explicit stack so deep mazes can't overflow
+ * the call stack
+ *
+ * @param maze  Tile map filled with walls
+ * @param start Starting position of the generation
+ * @param rng   Source of randomness
+ * @return void
+ */
+void BacktrackerGenerator::generate(TileMap &maze, Vector2D start, Random &rng) {
+    CellLattice lattice(maze, start);
+    std::vector<bool> visited(lattice.count(), false);
+    std::vector<int> stack;
+
+    int cell = lattice.cellOf(start);
+    maze[start] = TileObject::None;
+    visited[cell] = true;
+    stack.push_back(cell);
+
+    while (!stack.empty()) {
+        cell = stack.back();
+
+        // Collect every unvisited neighbour
+        int options[4], count = 0;
+        for (int dir = 0; dir < 4; dir++) {
+            int next = lattice.neighbour(cell, dir);
+            if (next != -1 && !visited[next])
+                options[count++] = next;
+        }
+
+        // Dead end, backtrack
+        if (count == 0) {
+            stack.pop_back();
+            continue;
+        }
+
+        int next = options[rng.nextInt(count)];
+        lattice.carve(maze, cell, next);
+        visited[next] = true;
+        stack.push_back(next);
+    }
+}
+
+const char *BacktrackerGenerator::getName() const {
+    return "Recursive Backtracker";
+}
+#pragma endregion
+
+#pragma region KRUSKAL
+/*
+ * Finds the root of a cell's set, halving the path on the way
+ */
+static int findSet(std::vector<int> &parent, int cell) {
+    while (parent[cell] != cell) {
+        parent[cell] = parent[parent[cell]];
+        cell = parent[cell];
+    }
+    return cell;
+}
+
+/*
+ * Carves a maze by opening walls in random order, skipping any wall whose
+ * two cells are already connected
+ *
+ * @param maze  Tile map filled with walls
+ * @param start Starting position of the generation
+ * @param rng   Source of randomness
+ * @return void
+ */
+void KruskalGenerator::generate(TileMap &maze, Vector2D start, Random &rng) {
+    CellLattice lattice(maze, start);
+    int cells = lattice.count();
+    maze[start] = TileObject::None;
+
+    // Every wall between 2 cells, stored as cell * 2 + (0 = right, 1 = down)
+    std::vector<int> walls;
+    walls.reserve(cells * 2);
+    for (int cell = 0; cell < cells; cell++) {
+        if (lattice.neighbour(cell, 3) != -1)
+            walls.push_back(cell * 2);
+        if (lattice.neighbour(cell, 2) != -1)
+            walls.push_back(cell * 2 + 1);
+    }
+
+    // Fisher-Yates shuffle
+    for (int i = int(walls.size()) - 1; i > 0; i--)
+        std::swap(walls[i], walls[rng.nextInt(i + 1)]);
+
+    std::vector<int> parent(cells), rank(cells, 0);
+    for (int cell = 0; cell < cells; cell++)
+        parent[cell] = cell;
+
+    for (int wall : walls) {
+        int a = wall / 2;
+        int b = lattice.neighbour(a, wall % 2 == 0 ? 3 : 2);
+        int rootA = findSet(parent, a), rootB = findSet(parent, b);
+        if (rootA == rootB)
+            continue;
+
+        // Union by rank
+        if (rank[rootA] < rank[rootB])
+            std::swap(rootA, rootB);
+        parent[rootB] = rootA;
+        if (rank[rootA] == rank[rootB])
+            rank[rootA]++;
+
+        lattice.carve(maze, a, b);
+    }
+}
+
+const char *KruskalGenerator::getName() const { return "Kruskal"; }
+#pragma endregion
+
+#pragma region WILSON
+/*
+ * Carves a maze with loop-erased random walks
+ * Each walk starts at a cell outside of the maze and wanders until it hits
+ * the maze. Only the last direction taken out of each cell is remembered, so
+ * loops are erased for free when the walk is carved.
+ *
+ * @param maze  Tile map filled with walls
+ * @param start Starting position of the generation
+ * @param rng   Source of randomness
+ * @return void
+ */
+void WilsonGenerator::generate(TileMap &maze, Vector2D start, Random &rng) {
+    CellLattice lattice(maze, start);
+    int cells = lattice.count();
+    std::vector<bool> inMaze(cells, false);
+    std::vector<signed char> exitDir(cells, -1);
+
+    inMaze[lattice.cellOf(start)] = true;
+    maze[start] = TileObject::None;
+
+    for (int first = 0; first < cells; first++) {
+        if (inMaze[first])
+            continue;
+
+        // Random walk until the maze is reached
+        int cell = first;
+        while (!inMaze[cell]) {
+            int dir, next;
+            do {
+                dir = rng.nextInt(4);
+                next = lattice.neighbour(cell, dir);
+            } while (next == -1);
+            exitDir[cell] = (signed char)dir;
+            cell = next;
+        }
+
+        // Carve the loop-erased path
+        cell = first;
+        while (!inMaze[cell]) {
+            int next = lattice.neighbour(cell, exitDir[cell]);
+            inMaze[cell] = true;
+            lattice.carve(maze, cell, next);
+            cell = next;
+        }
+    }
+}
+
+const char *WilsonGenerator::getName() const { return "Wilson"; }
+#pragma endregion
+
+#pragma region ELLER
+/*
+ * Carves a maze one row of cells at a time, see EllerStream
+ *
+ * @param maze  Tile map filled with walls
+ * @param start Starting position of the generation
+ * @param rng   Source of randomness
+ * @return void
+ */
+void EllerGenerator::generate(TileMap &maze, Vector2D start, Random &rng) {
+    GridSink sink(maze);
+    EllerStream stream(maze.getHeight(), maze.getWidth(), start, rng, sink);
+    stream.run();
+}
+
+const char *EllerGenerator::getName() const { return "Eller"; }
+#pragma endregion
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstddef>
+#include <stdint.h>
+#include <vector>
+
+/*
+ * Grid of bits stored as rows of 64-bit words
+ *
+ * Like Grid, the board has a one-tile border ring, so (-1, -1) to
+ * (height, width) are addressable. Bit x of a row is stored at bit (x + 1),
+ * and every row has a spare word at the end so a 3-bit window can always be
+ * read with two word loads.
+ *
+ * Usage:
+ * BitBoard open(5, 5, false);
+ * open.set(2, 2);
+ * int count = open.countAdjacent(2, 3); // count = 1
+ */
+class BitBoard {
+  private:
+    int height;
+    int width;
+    int words; // Number of words per row
+    std::vector<uint64_t> bits;
+
+    inline uint64_t *rowWords(int y) { return &this->bits[(y + 1) * words]; }
+    inline const uint64_t *rowWords(int y) const {
+        return &this->bits[(y + 1) * words];
+    }
+
+    /*
+     * Reads the 3 bits of a row centered on x
+     * bit 0 = x - 1, bit 1 = x, bit 2 = x + 1
+     */
+    inline uint64_t window(int y, int x) const {
+        const uint64_t *row = rowWords(y);
+        int index = x; // (x + 1) - 1
+        int word = index >> 6, offset = index & 63;
+        uint64_t value = row[word] >> offset;
+        if (offset > 61)
+            value |= row[word + 1] << (64 - offset);
+        return value & 7;
+    }
+
+  public:
+    BitBoard() : height(0), width(0), words(0) {}
+
+    /*
+     * @param height Number of rows in the usable area
+     * @param width  Number of columns in the usable area
+     * @param border Value of every bit in the border ring
+     */
+    BitBoard(int height, int width, bool border)
+        : height(height), width(width), words((width + 2 + 63) / 64 + 1),
+          bits(std::size_t(height + 2) * words, 0) {
+        if (!border)
+            return;
+        for (int x = -1; x <= width; x++) {
+            set(-1, x);
+            set(height, x);
+        }
+        for (int y = 0; y < height; y++) {
+            set(y, -1);
+            set(y, width);
+        }
+    }
+
+    inline int getHeight() const { return this->height; }
+    inline int getWidth() const { return this->width; }
+
+    inline bool test(int y, int x) const {
+        return (rowWords(y)[(x + 1) >> 6] >> ((x + 1) & 63)) & 1;
+    }
+    inline void set(int y, int x) {
+        rowWords(y)[(x + 1) >> 6] |= uint64_t(1) << ((x + 1) & 63);
+    }
+
+    /*
+     * Counts the set bits among the 4 tiles next to (y, x)
+     * Reads one 3-bit window from each of the 3 rows and merges them into a
+     * single mask, so it is one popcount instead of four branches
+     */
+    inline int countAdjacent(int y, int x) const {
+        uint64_t mask = (window(y - 1, x) & 2) | (window(y, x) & 5) |
+                        ((window(y + 1, x) & 2) << 2);
+        return __builtin_popcountll(mask);
+    }
+
+    /*
+     * Gets which of the 4 tiles next to (y, x) are clear in both boards
+     * bit 0 = up, bit 1 = left, bit 2 = down, bit 3 = right
+     */
+    inline int clearAdjacent(const BitBoard &other, int y, int x) const {
+        uint64_t up = window(y - 1, x) | other.window(y - 1, x);
+        uint64_t row = window(y, x) | other.window(y, x);
+        uint64_t down = window(y + 1, x) | other.window(y + 1, x);
+        uint64_t taken = ((up >> 1) & 1) | ((row & 1) << 1) |
+                         (down & 2) << 1 | ((row >> 2) & 1) << 3;
+        return int(~taken & 15);
+    }
+
+    /*
+     * Calls fn(y, x) for every set bit of the usable area, a whole word at a
+     * time, in row-major order
+     */
+    template <typename Fn> void forEachSet(Fn fn) const {
+        for (int y = 0; y < this->height; y++) {
+            const uint64_t *row = rowWords(y);
+            for (int w = 0; w < this->words; w++) {
+                uint64_t word = row[w];
+                while (word) {
+                    int x = w * 64 + __builtin_ctzll(word) - 1;
+                    word &= word - 1;
+                    if (x >= 0 && x < this->width)
+                        fn(y, x);
+                }
+            }
+        }
+    }
+};
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "enums.h"
+#include "generator.h"
+#include "vector2d.h"
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * Tile storage of a large maze, split into CHUNK_SIZE x CHUNK_SIZE chunks
+ * that are generated when first read and evicted when over budget
+ *
+ * Each chunk is carved on its own with a seed derived from the level seed &
+ * its position, so an evicted chunk comes back identical. Cells are the tiles
+ * on even coordinates. The last row & column of a chunk are a seam of walls
+ * with one door to the chunk below & on the right. Every chunk is connected
+ * and linked to its neighbours, so the whole maze is connected.
+ *
+ * Tiles changed with set() are kept in a sparse log per chunk and replayed
+ * when the chunk is generated again.
+ *
+ * Usage:
+ * ChunkMap chunks(10000, GeneratorType::Backtracker, seed);
+ * TileObject tile = chunks.get(5000, 5000); // Generates one chunk
+ */
+class ChunkMap {
+  public:
+    static const int CHUNK_SIZE = 64;
+
+  private:
+    struct Chunk {
+        std::vector<TileObject> tiles; // CHUNK_SIZE x CHUNK_SIZE, row-major
+        std::list<int>::iterator lruPos;
+    };
+
+    int size;
+    int chunksPerRow;
+    uint64_t seed;
+    std::unique_ptr<MazeGenerator> generator;
+    std::size_t maxChunks;
+    std::unordered_map<int, Chunk> chunks;
+    std::list<int> lru; // Keys of the loaded chunks, most recently used first
+    // Per chunk: local tile index -> tile set after generation
+    std::unordered_map<int, std::unordered_map<int, TileObject> > edits;
+    // Most reads hit the same chunk as the previous one
+    int lastKey;
+    Chunk *lastChunk;
+    std::size_t generated;
+
+    inline int keyOf(int y, int x) const {
+        return y / CHUNK_SIZE * this->chunksPerRow + x / CHUNK_SIZE;
+    }
+    static inline int localOf(int y, int x) {
+        return y % CHUNK_SIZE * CHUNK_SIZE + x % CHUNK_SIZE;
+    }
+
+    Chunk &load(int key);
+    void generateChunk(int key, Chunk &chunk);
+
+  public:
+    ChunkMap(int size, GeneratorType type, uint64_t seed, int maxChunks = 64);
+
+    inline int getSize() const { return this->size; }
+    inline int getLoadedChunks() const { return int(this->chunks.size()); }
+    // Number of chunk generations so far, evicted chunks count again
+    inline std::size_t getGenerated() const { return this->generated; }
+
+    /*
+     * Gets a tile, generating its chunk if it isn't loaded
+     *
+     * @return TileObject Border if the position is outside of the maze
+     */
+    inline TileObject get(int y, int x) {
+        if (y < 0 || x < 0 || y >= this->size || x >= this->size)
+            return TileObject::Border;
+        int key = keyOf(y, x);
+        Chunk &chunk = key == this->lastKey ? *this->lastChunk : load(key);
+        return chunk.tiles[localOf(y, x)];
+    }
+
+    void set(int y, int x, TileObject tile);
+    void preload(Vector2D center, int radius);
+};
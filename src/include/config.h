@@ -1,31 +1,29 @@
+#pragma once
+
+#include "enums.h"
 #include <iostream>
-#include <map>
 #include <string>
+#include <vector>
 
 const std::string GAME_FOLDER = "game_name";
 const std::string CONFIG_FILE = "config.txt";
 
+/*
+ * Settings of the game, read from config.txt once per load
+ *
+ * Every line of the file is a KEY=VALUE pair. Keys are matched exactly and
+ * the values are parsed into their type when the file is loaded, so a lookup
+ * is an array read and never touches the file. A setting that is missing or
+ * has a bad value keeps its default. Unknown keys, repeated keys and bad
+ * values are kept in getProblems() to be reported.
+ *
+ * Usage:
+ * Config &config = Config::getShared();
+ * int cap = config.getInt(Config::FRAME_CAP);
+ * KeyInput input = config.getKeyInput(getch());
+ */
 class Config {
-  private:
-    std::string configDir;
-    std::string getConfigDir();
-    void createDefaultConfig();
-    void addPair(std::string key, std::string value);
-    std::string getPair(std::string key);
-    std::map<int, std::string> getConfigKeys = {
-        {KB_UP, "KB_UP"},
-        {KB_DOWN, "KB_DOWN"},
-        {KB_LEFT, "KB_LEFT"},
-        {KB_RIGHT, "KB_RIGHT"},
-        {KB_CONFIRM, "KB_CONFIRM"},
-        {KB_CANCEL, "KB_CANCEL"},
-        {KB_USE_PICKAXE, "KB_USE_PICKAXE"},
-        {KB_USE_RATION, "KB_USE_RATION"},
-        {KB_EXIT, "KB_EXIT"},
-    };
-
   public:
-    Config();
     enum CONFIG_KEYS {
         KB_UP = 0,
         KB_DOWN,
@@ -36,8 +34,71 @@ class Config {
         KB_USE_PICKAXE,
         KB_USE_RATION,
         KB_EXIT,
+        KB_OVERLAY,
+        SEED,           // Seed of the game session, 0 picks one from the time
+        THREADS,        // Worker threads that build levels, 0 = main thread
+        RENDER_BACKEND, // curses, framebuffer or null
+        FRAME_CAP,      // Most frames per second while keys queue, 0 = none
+        SHOW_INTRO,     // Whether the intro plays on start
+        KEY_COUNT,
+    };
+
+  private:
+    // Value of a setting, parsed when the file is loaded
+    struct Setting {
+        std::string text;
+        long long number;
+        bool flag;
     };
+
+    std::string configDir;
+    std::string getConfigDir();
+    void createDefaultConfig();
+    std::string serialize() const;
+    bool parse(CONFIG_KEYS key, const std::string &text, Setting &setting);
+    std::string readFile() const;
+    void apply(const std::string &text);
+    void load();
+    Setting settings[KEY_COUNT];
+    std::string source; // Text of the file at the last load
+    std::vector<std::string> problems; // Found by the last load
+    // Action of every key code that fits in a byte, None if it isn't bound
+    KeyInput keymap[256];
+
+  public:
+    Config();
+    static Config &getShared();
+    static const char *getName(CONFIG_KEYS key);
+
     std::string getConfig(CONFIG_KEYS);
+    void reload();
+    bool reloadIfChanged();
+    bool save();
+
+    inline const std::string &getString(CONFIG_KEYS key) const {
+        return this->settings[key].text;
+    }
+    inline long long getInt(CONFIG_KEYS key) const {
+        return this->settings[key].number;
+    }
+    inline bool getBool(CONFIG_KEYS key) const {
+        return this->settings[key].flag;
+    }
+    inline const std::vector<std::string> &getProblems() const {
+        return this->problems;
+    }
+
+    /*
+     * Gets the action bound to a key, from the keymap built on load
+     *
+     * @param key Key code from getch
+     * @return KeyInput None if the key isn't bound
+     */
+    inline KeyInput getKeyInput(int key) const {
+        if (key < 0 || key > 255)
+            return KeyInput::None;
+        return this->keymap[key];
+    }
 
     // Get the absolute path to the config file
     std::string getConfigFilePath() const { return configDir + CONFIG_FILE; }
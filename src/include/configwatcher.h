@@ -0,0 +1,32 @@
+#pragma once
+
+#include <string>
+
+/*
+ * Watches a file for writes with inotify, without ever blocking
+ *
+ * The directory of the file is watched, not the file itself, so editors that
+ * save by writing a new file and renaming it over the old one are seen too.
+ * poll() only drains the events that are already queued, so it can be called
+ * every frame. Where inotify isn't available poll() always returns false.
+ *
+ * Usage:
+ * ConfigWatcher watcher(config.getConfigFilePath());
+ * if (watcher.poll())
+ *     config.reloadIfChanged();
+ */
+class ConfigWatcher {
+  private:
+    int fd;    // inotify instance, -1 if it couldn't be created
+    int watch; // Watch on the directory of the file
+    std::string name; // Name of the file inside the directory
+
+  public:
+    ConfigWatcher(const std::string &path);
+    ~ConfigWatcher();
+    ConfigWatcher(const ConfigWatcher &) = delete;
+    ConfigWatcher &operator=(const ConfigWatcher &) = delete;
+
+    bool poll();
+    inline bool isActive() const { return this->fd >= 0; }
+};
@@ -3,14 +3,27 @@
 #include "enums.h"
 #include "level.h"
 #include "player.h"
+#include "renderer.h"
+#include "screenbuffer.h"
+#include <memory>
 #include <unistd.h>
 /*
  * Class to store functions to draw the game on the console
+ * Frames are drawn into a ScreenBuffer and presented to a Renderer, which is
+ * the terminal unless another backend is set
  */
 class Display {
   public:
     static void initCurses();
     static void flush();
+    static void present();
+    static void setFrameCap(int fps);
+    static bool isFrameDue();
+    static void setRenderer(std::unique_ptr<Renderer> backend);
+    static Renderer &getRenderer();
+    static void toggleOverlay();
+    static bool isOverlayShown();
+    static ScreenBuffer &getScreen();
     static void drawLevel(const Level &level, const Player &player,
                           int currentLevel, std::string &text,
                           KeyInput lastDirectionalInput = KeyInput::None);
@@ -23,10 +36,12 @@ class Display {
                       const std::vector<std::unique_ptr<Item> > &inventory);
     static void drawItemMenu(int highlighted, std::string desc);
     static void drawGameOverMenu(int highlighted);
+    static const int INTRO_TICK_MS = 10; // Length of a tick of the intro
     static void drawIntro();
+    static bool drawIntroFrame(int tick);
+    static int getIntroTicks();
     static void drawScrollingText(const std::string &text,
-                                  std::pair<int, int> pos = {-1, -1},
-                                  int updates = 10, bool mirrored = false,
-                                  bool bold = false);
+                                  std::pair<int, int> pos, int shown,
+                                  bool mirrored = false, bool bold = false);
     static void terminate();
 };
\ No newline at end of file
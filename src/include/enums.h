@@ -1,5 +1,6 @@
 #pragma once
 
+#include "grid.h"
 #include <vector>
 
 /*
@@ -18,8 +19,8 @@ enum GameState {
 };
 
 // Enum for different tile objects (anything that appears on the map is a tile
-// object)
-enum class TileObject {
+// object). Stored as a single byte to keep the tile map compact
+enum class TileObject : unsigned char {
     Player,      // Player
     Wall,        // Maze Wall
     None,        // Path
@@ -28,11 +29,43 @@ enum class TileObject {
     EnergyDrink, // Max Stamina Boost (temporary) (also regenerates stamina)
     Pickaxe,     // Doesn't do anything for now
     Chest,       // Gives random item
-    Ink          // Marks walked tiles
+    Ink,         // Marks walked tiles
+    Border       // Solid perimeter around the maze, never part of the level
 };
 
-// Declares TileMap to wrap 2d vector of TileObject into a more readable form
-typedef std::vector<std::vector<TileObject> > TileMap;
+// Declares TileMap to wrap the bordered grid of TileObject into a more
+// readable form
+typedef Grid<TileObject> TileMap;
+typedef GridView<TileObject> TileView;
+
+// Enum for how Level keeps track of open tiles while generating the maze
+enum class GenerationMode {
+    Scalar,  // Reads neighbours tile by tile from the tile map
+    Bitboard // Keeps open tiles as 64-bit bit rows
+};
+
+// Enum for the available maze generation algorithms
+enum class GeneratorType {
+    Prim,         // Randomized Prim's on tiles
+    PrimBitboard, // Randomized Prim's on tiles, tracked with bitboards
+    Backtracker,  // Iterative recursive backtracker
+    Kruskal,      // Randomized Kruskal's with union-find
+    Wilson,       // Wilson's loop-erased random walks
+    Eller         // Eller's row by row algorithm
+};
+
+// Enum for how the player's field of view is worked out
+enum class SightMode {
+    Radius,     // Every tile within the radius, walls don't block sight
+    LineOfSight // The radius, plus tiles in line of sight a bit further out
+};
+
+// Enum for where Display sends the finished frames
+enum class RendererType {
+    Curses,      // The terminal, through ncurses
+    Framebuffer, // Cells kept in memory, for tests & golden frames
+    Null         // Cells are only counted, for timing the drawing alone
+};
 
 // Enum for the 3 levels of difficulty (to be implemented after MVP)
 enum Difficulty {
@@ -52,6 +85,7 @@ enum class KeyInput {
     UseAbility,
     UsePickaxe,
     UseRation,
+    ToggleOverlay,
     Exit,
     None
 };
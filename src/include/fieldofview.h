@@ -0,0 +1,86 @@
+#pragma once
+
+#include "fovmask.h"
+#include "vector2d.h"
+#include <stdint.h>
+#include <unordered_map>
+
+class Level;
+
+/*
+ * Tiles seen from one position, as offsets from that position
+ * Every row is a bitmask of the columns from -MAX_RADIUS to MAX_RADIUS
+ */
+class Sight {
+  public:
+    static const int MAX_RADIUS = FovMask::MAX_RADIUS;
+
+  private:
+    Vector2D origin;
+    int radius;
+    uint32_t rows[2 * MAX_RADIUS + 1];
+
+    friend class FieldOfView;
+
+  public:
+    Sight() : radius(0), rows() {}
+
+    inline Vector2D getOrigin() const { return this->origin; }
+    inline int getRadius() const { return this->radius; }
+
+    inline bool contains(int dy, int dx) const {
+        if (dy < -MAX_RADIUS || dy > MAX_RADIUS || dx < -MAX_RADIUS ||
+            dx > MAX_RADIUS)
+            return false;
+        return (this->rows[dy + MAX_RADIUS] >> (dx + MAX_RADIUS)) & 1;
+    }
+
+    inline void mark(int dy, int dx) {
+        this->rows[dy + MAX_RADIUS] |= uint32_t(1) << (dx + MAX_RADIUS);
+    }
+
+    int count() const;
+};
+
+/*
+ * Line of sight over a level with recursive shadowcasting
+ *
+ * Each of the 8 octants around the origin is scanned row by row, and a wall
+ * splits the lit arc so the tiles behind it are skipped, not tested. Only the
+ * tiles that are lit plus the walls that bound them are read, so a query
+ * costs O(visible tiles) and doesn't depend on the size of the map. Visible
+ * tiles are also inside the circle of FovMask, so an open room looks the
+ * same as the radius test.
+ *
+ * Results are cached by (position, radius). A cached sight only changes when
+ * a wall near it does, so Level::setTile calls invalidate() for those.
+ *
+ * Usage:
+ * const Sight &sight =
+ *     level.getSight(player.getPos(), player.getSightRange());
+ * bool visible = sight.contains(dy, dx);
+ */
+class FieldOfView {
+  public:
+    static const int MAX_ENTRIES = 1024; // The cache is dropped when full
+
+  private:
+    std::unordered_map<uint64_t, Sight> cache;
+    int computed; // Number of sights that were cast, not found in the cache
+    int touched;  // Tiles read by the last cast
+
+    void castOctant(const Level &level, Sight &sight, int row, double start,
+                    double end, int xx, int xy, int yx, int yy);
+    bool isOpaque(const Level &level, Vector2D pos);
+
+  public:
+    FieldOfView();
+
+    const Sight &get(const Level &level, Vector2D origin, int radius);
+    void invalidate(Vector2D pos);
+    void clear();
+
+    inline int getCacheSize() const { return int(this->cache.size()); }
+    inline int getComputed() const { return this->computed; }
+    inline int getTouched() const { return this->touched; }
+};
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdlib>
+
+/*
+ * Circular field of view stencils, one per radius from 0 to MAX_RADIUS
+ *
+ * A tile at offset (dy, dx) from the player is visible if its distance rounds
+ * to at most the radius, round(sqrt(dy^2 + dx^2)) <= r, which is the same as
+ * dy^2 + dx^2 <= r * (r + 1). Each row of a circle is a single run of tiles,
+ * so a mask only stores how far every row reaches. The masks are built once,
+ * the first time one is used.
+ *
+ * Usage:
+ * const FovMask &mask = FovMask::get(player.getFov());
+ * bool visible = mask.contains(dy, dx);
+ */
+class FovMask {
+  public:
+    static const int MAX_RADIUS = 10; // Player::postUpdate clamps the FOV
+
+  private:
+    int radius;
+    int reach[MAX_RADIUS + 1]; // Furthest visible |dx| on row |dy|
+
+  public:
+    FovMask(int radius = 0);
+
+    static const FovMask &get(int radius);
+
+    inline int getRadius() const { return this->radius; }
+
+    // Furthest visible |dx| on a row, -1 if nothing on it is visible
+    inline int getReach(int dy) const {
+        dy = std::abs(dy);
+        return dy > this->radius ? -1 : this->reach[dy];
+    }
+
+    inline bool contains(int dy, int dx) const {
+        return std::abs(dx) <= getReach(dy);
+    }
+};
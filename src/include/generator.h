@@ -0,0 +1,87 @@
+#pragma once
+
+#include "enums.h"
+#include "random.h"
+#include "vector2d.h"
+#include <memory>
+#include <vector>
+
+/*
+ * Interface for maze generation algorithms
+ *
+ * A generator receives a tile map filled with walls and carves paths into it.
+ * Every walkable tile it creates must be reachable from the start position.
+ * All randomness comes from the given Random, so a seed gives one maze.
+ *
+ * Usage:
+ * std::unique_ptr<MazeGenerator> generator =
+ *     MazeGenerator::create(GeneratorType::Kruskal);
+ * Level level(size, Vector2D(0, 0), itemCount, *generator, seed);
+ */
+class MazeGenerator {
+  public:
+    virtual ~MazeGenerator() {}
+    virtual void generate(TileMap &maze, Vector2D start, Random &rng) = 0;
+    virtual const char *getName() const = 0;
+
+    static std::unique_ptr<MazeGenerator> create(GeneratorType type);
+};
+
+/*
+ * Iterative Randomized Prim's Algorithm on individual tiles
+ * A wall is removed if it is connected to exactly one empty tile
+ */
+class PrimGenerator : public MazeGenerator {
+  private:
+    GenerationMode mode;
+    std::vector<Vector2D> wallList;
+    std::vector<bool> queued; // Walls that have been added to wallList
+    TileMap *maze;
+    Random *rng;
+    int size;
+
+    void generateScalar(Vector2D pos);
+    void generateBitboard(Vector2D pos);
+    void queueWall(Vector2D pos);
+    void getAdjWalls(Vector2D pos);
+    bool verifyWall(Vector2D wallPos) const;
+
+  public:
+    PrimGenerator(GenerationMode mode = GenerationMode::Scalar);
+    void generate(TileMap &maze, Vector2D start, Random &rng);
+    const char *getName() const;
+};
+
+/*
+ * The generators below work on a lattice of cells: tiles with the same
+ * parity as the start position are cells, the tiles between two cells are
+ * the walls that can be opened
+ */
+
+// Depth-first search with an explicit stack (recursive backtracker)
+class BacktrackerGenerator : public MazeGenerator {
+  public:
+    void generate(TileMap &maze, Vector2D start, Random &rng);
+    const char *getName() const;
+};
+
+// Randomized Kruskal's algorithm with a union-find over the cells
+class KruskalGenerator : public MazeGenerator {
+  public:
+    void generate(TileMap &maze, Vector2D start, Random &rng);
+    const char *getName() const;
+};
+
+// Wilson's algorithm (loop-erased random walks), unbiased spanning trees
+class WilsonGenerator : public MazeGenerator {
+  public:
+    void generate(TileMap &maze, Vector2D start, Random &rng);
+    const char *getName() const;
+};
+
+// Eller's algorithm, carves one row of cells at a time
+class EllerGenerator : public MazeGenerator {
+  public:
+    void generate(TileMap &maze, Vector2D start, Random &rng);
+    const char *getName() const;
+};
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "vector2d.h"
+#include <cstddef>
+#include <vector>
+
+/*
+ * Read-only window into the tiles of a Grid, doesn't own or copy them
+ * Rows are stride tiles apart, so a view can be a rectangle inside a larger
+ * grid. A view of a whole grid can also read its border ring.
+ *
+ * Usage:
+ * GridView<int> window = grid.view(1, 1, 2, 2);
+ * int value = window(0, 0); // value = grid(1, 1)
+ */
+template <typename T> class GridView {
+  private:
+    const T *origin; // Tile (0, 0) of the view
+    int height;
+    int width;
+    int stride;
+
+  public:
+    GridView() : origin(nullptr), height(0), width(0), stride(0) {}
+    GridView(const T *origin, int height, int width, int stride)
+        : origin(origin), height(height), width(width), stride(stride) {}
+
+    inline int getHeight() const { return this->height; }
+    inline int getWidth() const { return this->width; }
+    inline int getStride() const { return this->stride; }
+    inline bool empty() const { return this->origin == nullptr; }
+
+    inline const T &operator()(int y, int x) const {
+        return this->origin[std::ptrdiff_t(y) * this->stride + x];
+    }
+    inline const T &operator[](Vector2D pos) const {
+        return (*this)(pos.y, pos.x);
+    }
+
+    // Pointer to the first tile of a row, the row has width tiles
+    inline const T *row(int y) const {
+        return this->origin + std::ptrdiff_t(y) * this->stride;
+    }
+    // Pointer to tile (0, 0), the next row starts stride tiles later
+    inline const T *data() const { return this->origin; }
+};
+
+/*
+ * Contiguous row-major 2D grid with a one-tile border ring around it
+ *
+ * The usable area is (0, 0) to (height - 1, width - 1). The ring around it
+ * (row/column -1 and height/width) is always addressable and holds a sentinel
+ * value, so neighbours of any in-bounds tile can be read without bounds checks.
+ *
+ * Usage:
+ * Grid<int> grid(3, 3, 0, -1);
+ * grid(1, 1) = 5;
+ * int border = grid(-1, 0); // border = -1
+ */
+template <typename T> class Grid {
+  private:
+    int height;
+    int width;
+    int stride; // Distance between two rows in cells (width + 2)
+    std::vector<T> cells;
+
+  public:
+    Grid() : height(0), width(0), stride(2) {}
+
+    /*
+     * @param height Number of rows in the usable area
+     * @param width  Number of columns in the usable area
+     * @param fill   Value of every tile in the usable area
+     * @param border Sentinel value of the border ring
+     */
+    Grid(int height, int width, const T &fill, const T &border)
+        : height(height), width(width), stride(width + 2),
+          cells(std::size_t(height + 2) * (width + 2), border) {
+        for (int y = 0; y < height; y++)
+            for (int x = 0; x < width; x++)
+                (*this)(y, x) = fill;
+    }
+
+    inline int getHeight() const { return this->height; }
+    inline int getWidth() const { return this->width; }
+    inline int getStride() const { return this->stride; }
+
+    // Checks if a position is inside the usable area (excludes the border)
+    inline bool inBounds(int y, int x) const {
+        return y >= 0 && x >= 0 && y < this->height && x < this->width;
+    }
+    inline bool inBounds(Vector2D pos) const { return inBounds(pos.y, pos.x); }
+
+    // Index of a tile in the underlying storage, valid from -1 to height/width
+    inline std::size_t indexOf(int y, int x) const {
+        return std::size_t(y + 1) * this->stride + (x + 1);
+    }
+
+    inline T &operator()(int y, int x) { return this->cells[indexOf(y, x)]; }
+    inline const T &operator()(int y, int x) const {
+        return this->cells[indexOf(y, x)];
+    }
+    inline T &operator[](Vector2D pos) { return (*this)(pos.y, pos.x); }
+    inline const T &operator[](Vector2D pos) const {
+        return (*this)(pos.y, pos.x);
+    }
+
+    // Pointer to the first usable tile of a row, the row has width tiles
+    inline T *row(int y) { return &this->cells[indexOf(y, 0)]; }
+    inline const T *row(int y) const { return &this->cells[indexOf(y, 0)]; }
+
+    // View of a rectangle, from (top, left) which may be on the border ring
+    inline GridView<T> view(int top, int left, int height, int width) const {
+        return GridView<T>(&(*this)(top, left), height, width, this->stride);
+    }
+    // View of the usable area
+    inline GridView<T> view() const {
+        return view(0, 0, this->height, this->width);
+    }
+
+    // Size of the whole grid in bytes, border included
+    inline std::size_t getBytes() const {
+        return this->cells.capacity() * sizeof(T);
+    }
+};
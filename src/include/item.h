@@ -6,6 +6,7 @@
 #include "enums.h"
 
 class Player;
+class Random;
 
 
  /*
@@ -39,7 +40,7 @@ class Item {
     Item();
     Item(int id, const std::string& name, const std::string& description, int rarity, bool hasCustomBehavior, const std::vector<int> &flatBonus, const std::vector<float> &mult);
 
-    void update(Player& player);
+    void update(Player& player, Random &rng);
   
 };
 
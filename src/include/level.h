@@ -1,39 +1,80 @@
 #pragma once
+#include "chunkmap.h"
 #include "enums.h"
+#include "fieldofview.h"
+#include "generator.h"
+#include "random.h"
 #include "vector2d.h"
+#include <memory>
 #include <vector>
 
 /*
  * Class to store the current level's maze layout
- * has functions to generate the maze
+ * The maze is carved by a MazeGenerator, then the exit & items are placed.
+ * Without one the maze is carved with Randomized Prim's.
+ *
+ * Large levels can use chunked storage instead (see Level::chunked), where
+ * chunks are only generated when read. Tile access works the same, but there
+ * is no distance field since the maze is never whole.
  */
 class Level {
   private:
     TileMap maze;
-    std::vector<Vector2D> wallList;
+    std::unique_ptr<ChunkMap> chunks; // Only set for chunked levels
+    // Tiles of the last view of a chunked level, reused between calls
+    mutable std::vector<TileObject> viewBuffer;
+    Random rng; // Randomness of this level only
+    // Path distance of every tile from the start, -1 if it can't be reached
+    Grid<int> distances;
+    // Reachable path tiles in BFS order, so by increasing distance
+    std::vector<Vector2D> pathTiles;
+    // Line of sight cache, walls only change through setTile
+    mutable FieldOfView sight;
     Vector2D startPos;
     Vector2D endPos;
     int itemCount;
     int size;
     bool gameStatus;
+    // Milliseconds spent generating, 0 when the profiler is compiled out
+    double generationTime;
 
-    void generateMaze(Vector2D pos);
-    void getAdjWalls(Vector2D pos);
-    bool verifyWall(Vector2D wallPos);
+    void build(int size, Vector2D startPos, int itemCount,
+               MazeGenerator &generator);
+    void computeDistances();
     void placeItems(int itemCount);
+    void placeChunked();
+    TileObject rollItem(int index);
     void setExit();
 
     void print();
 
+    Level();
+
   public:
-    Level(int size, Vector2D startPos, int itemCount);
+    Level(int size, Vector2D startPos, int itemCount, uint64_t seed = 0);
+    Level(int size, Vector2D startPos, int itemCount,
+          MazeGenerator &generator, uint64_t seed = 0);
+    static Level chunked(int size, Vector2D startPos, int itemCount,
+                         GeneratorType type, uint64_t seed = 0,
+                         int maxChunks = 64);
+    bool isChunked() const;
+    void preload(Vector2D pos, int radius);
     int getSize() const;
     TileMap getMaze() const;
+    TileView getView() const;
+    TileView getView(int top, int left, int height, int width) const;
+    const TileObject *getRow(int y) const;
     Vector2D getStart() const;
     Vector2D getEnd() const;
     TileObject getTile(Vector2D pos) const;
     bool getGameStatus() const;
+    double getGenerationTime() const;
+    int getDistance(Vector2D pos) const;
+    int getMaxDistance() const;
+    const Grid<int> &getDistances() const;
+    const std::vector<Vector2D> &getPathTiles() const;
     bool isValidMove(Vector2D playerPos) const;
+    const Sight &getSight(Vector2D pos, int radius) const;
     void setTile(Vector2D pos, TileObject target);
     // bool isRemovableWall(Vector2D pos) const;
 };
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "enums.h"
+#include "random.h"
+#include "vector2d.h"
+#include <ostream>
+#include <string>
+#include <vector>
+
+/*
+ * Receives the rows of a streamed maze, from top to bottom
+ * Each row is only valid during the call, copy it to keep it
+ */
+class RowSink {
+  public:
+    virtual ~RowSink() {}
+    virtual void consumeRow(int y, const TileObject *row, int width) = 0;
+};
+
+/*
+ * Writes streamed rows into a tile map
+ */
+class GridSink : public RowSink {
+  private:
+    TileMap &maze;
+
+  public:
+    GridSink(TileMap &maze) : maze(maze) {}
+    void consumeRow(int y, const TileObject *row, int width);
+};
+
+/*
+ * Writes streamed rows as text, '#' for walls and ' ' for paths
+ */
+class FileSink : public RowSink {
+  private:
+    std::ostream &out;
+    std::string line;
+
+  public:
+    FileSink(std::ostream &out) : out(out) {}
+    void consumeRow(int y, const TileObject *row, int width);
+};
+
+/*
+ * Eller's algorithm that emits the maze one tile row at a time
+ *
+ * Only the sets of the current row of cells and two rows of tiles are kept,
+ * so memory is bounded by the width of the maze, not its area. Cells are the
+ * tiles with the same parity as the start position, like the other lattice
+ * generators.
+ *
+ * Usage:
+ * FileSink sink(std::cout);
+ * Random rng(seed);
+ * EllerStream stream(100000, 81, Vector2D(0, 0), rng, sink);
+ * stream.run();
+ */
+class EllerStream {
+  private:
+    RowSink &sink;
+    Random &rng;
+    int height, width; // Size of the maze in tiles
+    int offsetY, offsetX;
+    int rows, cols; // Size of the maze in cells
+    int cellRow;    // Next row of cells to carve
+    int tileRow;    // Next row of tiles to emit
+
+    // Sets of the current row, -1 = new cell that isn't in any set yet
+    std::vector<int> sets;
+    // Union-find over the set labels of the current row
+    std::vector<int> parent, remap;
+    // Per set: how many cells it has & which cell is picked if none of them
+    // went down
+    std::vector<int> members, picked;
+    std::vector<bool> goesDown, down;
+    // Tile row of the cells & tile row of the passages below them
+    std::vector<TileObject> cellTiles, passageTiles, wallTiles;
+
+    int findSet(int label);
+    void carveRow();
+
+  public:
+    EllerStream(int height, int width, Vector2D start, Random &rng,
+                RowSink &sink);
+    bool step();
+    void run();
+};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "item.h"
+#include "random.h"
 #include "vector2d.h"
 #include <memory>
 #include <vector>
@@ -67,6 +68,8 @@ class Player {
         int itemID,
         std::vector<std::vector<std::unique_ptr<Item> > > &unobtainedItems);
     bool hasItem(int itemID) const;
+    SightMode getSightMode() const;
+    int getSightRange() const;
 
     inline const std::vector<std::unique_ptr<Item> > &getInventory() const {
         return this->inventory;
@@ -76,7 +79,7 @@ class Player {
 #pragma endregion
 
     void preUpdate();  // Prepares the player instance for update()
-    void update();     // Updates statz & shitz
+    void update(Random &rng); // Updates statz & shitz
     void postUpdate(); // Cleans up
 
     bool useRation();
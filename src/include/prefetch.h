@@ -0,0 +1,56 @@
+#pragma once
+
+#include "enums.h"
+#include "level.h"
+#include "vector2d.h"
+#include <future>
+#include <stdint.h>
+
+/*
+ * Builds the next level on a worker thread while the current one is played
+ *
+ * A request records the parameters of the level. take() hands the level
+ * over if it was built with the same parameters, otherwise it builds one
+ * synchronously, so the result only depends on the parameters and never on
+ * the timing of the worker.
+ *
+ * Usage:
+ * LevelPrefetcher prefetcher;
+ * prefetcher.request(params);
+ * ...
+ * Level next = prefetcher.take(params);
+ */
+class LevelPrefetcher {
+  public:
+    // Side length above which layers use chunked storage, in tiles
+    static const int CHUNKED_SIZE = 1024;
+    // Chunks around the start loaded by the worker, view radius + half a chunk
+    static const int PRELOAD_RADIUS = 10 + ChunkMap::CHUNK_SIZE / 2;
+
+    struct Params {
+        int size;
+        Vector2D startPos;
+        int itemCount;
+        GeneratorType type;
+        uint64_t seed;
+
+        bool operator==(const Params &other) const;
+    };
+
+  private:
+    Params pending;
+    std::future<Level> future;
+    bool async; // Whether requests use a worker thread at all
+
+    static Level build(Params params);
+
+  public:
+    LevelPrefetcher(bool async = true);
+    ~LevelPrefetcher();
+
+    void request(const Params &params);
+    bool isPending(const Params &params) const;
+    bool isReady() const;
+    Level take(const Params &params);
+    void cancel();
+};
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <chrono>
+
+// Build with -DENABLE_PROFILER=0 (make PROFILE=0) to compile the timers out
+#ifndef ENABLE_PROFILER
+#define ENABLE_PROFILER 1
+#endif
+
+/*
+ * Rolling frame statistics for the debug overlay
+ *
+ * Timers keep their last WINDOW samples and report the average, counters
+ * keep the value of the last frame. Everything is recorded through the
+ * PROFILE_* macros below, which expand to nothing when the profiler is
+ * compiled out, so a release build pays nothing for them.
+ *
+ * The game is driven by input, so a frame starts when Display::flush() blanks
+ * the back buffer and ends when Display::present() has sent it. The latency
+ * is from the key press that was read until the frame that answers it is
+ * presented.
+ *
+ * Usage:
+ * void drawSomething() {
+ *     PROFILE_SCOPE(Profiler::Draw);
+ *     ...
+ * }
+ * double draw = Profiler::getAverage(Profiler::Draw); // Milliseconds
+ */
+class Profiler {
+  public:
+    enum Timer {
+        Frame,   // Frame start to presented
+        Latency, // Input read to presented
+        Draw,    // Drawing the level into the back buffer
+        Present, // Sending the frame to the renderer
+        Startup, // Start of the game to the main menu shown
+        TIMER_COUNT
+    };
+    enum Counter {
+        TilesDrawn,  // Visible tiles of the level view
+        CellsSent,   // Screen cells that changed
+        CursesCalls, // Calls made by the curses renderer, refresh included
+        COUNTER_COUNT
+    };
+    static const int WINDOW = 32; // Samples in the rolling averages
+
+    typedef std::chrono::steady_clock Clock;
+
+    static void addTime(Timer timer, double ms);
+    static void setCount(Counter counter, int value);
+    static double getAverage(Timer timer);
+    static int getCount(Counter counter);
+
+    static void markInput();
+    static void beginFrame();
+    static void endFrame();
+    static void reset();
+
+    static inline bool isEnabled() { return ENABLE_PROFILER != 0; }
+};
+
+/*
+ * Measures the time until the end of its scope, into a profiler timer or a
+ * variable (in milliseconds)
+ */
+class ScopedTimer {
+  private:
+    Profiler::Clock::time_point start;
+    Profiler::Timer timer;
+    double *target;
+
+  public:
+    ScopedTimer(Profiler::Timer timer)
+        : start(Profiler::Clock::now()), timer(timer), target(nullptr) {}
+    ScopedTimer(double &target)
+        : start(Profiler::Clock::now()), timer(Profiler::TIMER_COUNT),
+          target(&target) {}
+
+    ~ScopedTimer() {
+        double ms = std::chrono::duration<double, std::milli>(
+                        Profiler::Clock::now() - this->start)
+                        .count();
+        if (this->target)
+            *this->target = ms;
+        else
+            Profiler::addTime(this->timer, ms);
+    }
+};
+
+#define PROFILE_JOIN_(a, b) a##b
+#define PROFILE_JOIN(a, b) PROFILE_JOIN_(a, b)
+
+#if ENABLE_PROFILER
+// Times the rest of the scope, into a Profiler::Timer or a double
+#define PROFILE_SCOPE(into) ScopedTimer PROFILE_JOIN(profileTimer, __LINE__)(into)
+#define PROFILE_COUNT(counter, value) Profiler::setCount(counter, value)
+#define PROFILE_TIME(timer, ms) Profiler::addTime(timer, ms)
+#define PROFILE_INPUT() Profiler::markInput()
+#define PROFILE_BEGIN_FRAME() Profiler::beginFrame()
+#define PROFILE_END_FRAME() Profiler::endFrame()
+#else
+// sizeof doesn't evaluate its operand, it only keeps the values "used"
+#define PROFILE_SCOPE(into) ((void)sizeof(into))
+#define PROFILE_COUNT(counter, value) ((void)sizeof(counter), (void)sizeof(value))
+#define PROFILE_TIME(timer, ms) ((void)sizeof(timer), (void)sizeof(ms))
+#define PROFILE_INPUT() ((void)0)
+#define PROFILE_BEGIN_FRAME() ((void)0)
+#define PROFILE_END_FRAME() ((void)0)
+#endif
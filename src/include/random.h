@@ -0,0 +1,103 @@
+#pragma once
+
+#include <stdint.h>
+#include <utility>
+#include <vector>
+
+/*
+ * Small, fast pseudo-random number generator (xoshiro256**)
+ *
+ * Each instance has its own state, so levels can be generated in parallel and
+ * the same seed always gives the same sequence. Replaces the global rand().
+ *
+ * Usage:
+ * Random rng(1340);
+ * int roll = rng.nextInt(100); // 0 to 99, without modulo bias
+ */
+class Random {
+  private:
+    uint64_t state[4];
+    uint64_t seed;
+
+    static inline uint64_t rotl(uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+  public:
+    Random(uint64_t seed = 0);
+
+    inline uint64_t getSeed() const { return this->seed; }
+
+    // Next raw 64-bit value
+    inline uint64_t next() {
+        uint64_t result = rotl(this->state[1] * 5, 7) * 9;
+        uint64_t t = this->state[1] << 17;
+        this->state[2] ^= this->state[0];
+        this->state[3] ^= this->state[1];
+        this->state[1] ^= this->state[2];
+        this->state[0] ^= this->state[3];
+        this->state[2] ^= t;
+        this->state[3] = rotl(this->state[3], 45);
+        return result;
+    }
+
+    /*
+     * Uniform integer in [0, bound) using Lemire's multiply & reject method,
+     * so there is no modulo bias and usually no division
+     *
+     * @param bound Exclusive upper bound, must be > 0
+     * @return int
+     */
+    inline int nextInt(int bound) {
+        uint32_t range = uint32_t(bound);
+        uint64_t product = (this->next() >> 32) * range;
+        uint32_t low = uint32_t(product);
+        if (low < range) {
+            uint32_t threshold = uint32_t(-range) % range;
+            while (low < threshold) {
+                product = (this->next() >> 32) * range;
+                low = uint32_t(product);
+            }
+        }
+        return int(product >> 32);
+    }
+
+    // True with a chance of numerator / denominator
+    inline bool chance(int numerator, int denominator) {
+        return nextInt(denominator) < numerator;
+    }
+
+    /*
+     * Picks count distinct elements that match a predicate, in one pass
+     * Reservoir sampling over the matching elements, then a shuffle of the
+     * picks so their order is random too. O(n + count), nothing is erased.
+     *
+     * @param list  Elements to pick from
+     * @param count Number of elements to pick
+     * @param keep  Predicate, only elements it returns true for are picked
+     * @return std::vector<T> Fewer than count elements if not enough match
+     */
+    template <typename T, typename Pred>
+    std::vector<T> sample(const std::vector<T> &list, int count, Pred keep) {
+        std::vector<T> picked;
+        if (count <= 0)
+            return picked;
+        picked.reserve(count);
+        int seen = 0;
+        for (const T &value : list) {
+            if (!keep(value))
+                continue;
+            seen++;
+            if (int(picked.size()) < count) {
+                picked.push_back(value);
+                continue;
+            }
+            int index = nextInt(seen);
+            if (index < count)
+                picked[index] = value;
+        }
+        for (int i = int(picked.size()) - 1; i > 0; i--)
+            std::swap(picked[i], picked[nextInt(i + 1)]);
+        return picked;
+    }
+};
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "enums.h"
+#include <memory>
+#include <ncurses.h>
+#include <string>
+#include <vector>
+
+/*
+ * Interface for where finished frames go
+ *
+ * ScreenBuffer draws a frame into its cells, then hands the runs of cells that
+ * changed to a renderer and ends the frame. A renderer also tells how big the screen
+ * is, so Display can be used without a terminal.
+ *
+ * Usage:
+ * Display::setRenderer(Renderer::create(RendererType::Framebuffer, 40, 120));
+ * Display::drawMainMenu(0);
+ * Display::present();
+ */
+class Renderer {
+  public:
+    virtual ~Renderer() {}
+    virtual int getHeight() const = 0;
+    virtual int getWidth() const = 0;
+    // Writes count cells of a row from (y, x), the run never wraps
+    virtual void drawSpan(int y, int x, const chtype *cells, int count) = 0;
+    virtual void endFrame() = 0;
+    virtual const char *getName() const = 0;
+
+    /*
+     * @param height Rows of the in-memory backends, curses uses the terminal
+     * @param width  Columns of the in-memory backends
+     */
+    static std::unique_ptr<Renderer> create(RendererType type, int height = 24,
+                                            int width = 80);
+};
+
+/*
+ * Writes to the curses screen, curses must be initialized first
+ * Each run is one mvaddchnstr call, the calls of the last frame are counted
+ */
+class CursesRenderer : public Renderer {
+  private:
+    int calls;     // Curses calls of the frame being drawn
+    int lastCalls; // Curses calls of the last frame, refresh included
+
+  public:
+    CursesRenderer();
+
+    int getHeight() const;
+    int getWidth() const;
+    void drawSpan(int y, int x, const chtype *cells, int count);
+    void endFrame();
+    const char *getName() const;
+
+    inline int getLastCalls() const { return this->lastCalls; }
+};
+
+/*
+ * Keeps the frame in memory, so tests can read it back
+ * toString() gives the characters without attributes, one line per row
+ */
+class FrameRenderer : public Renderer {
+  private:
+    int height;
+    int width;
+    int frames;
+    std::vector<chtype> cells;
+
+  public:
+    FrameRenderer(int height, int width);
+
+    int getHeight() const;
+    int getWidth() const;
+    void drawSpan(int y, int x, const chtype *cells, int count);
+    void endFrame();
+    const char *getName() const;
+
+    inline int getFrames() const { return this->frames; }
+    chtype getCell(int y, int x) const;
+    std::string getLine(int y) const;
+    std::string toString() const;
+};
+
+// Only counts what it receives
+class NullRenderer : public Renderer {
+  private:
+    int height;
+    int width;
+    int frames;
+    long cells;
+    long spans;
+
+  public:
+    NullRenderer(int height, int width);
+
+    int getHeight() const;
+    int getWidth() const;
+    void drawSpan(int y, int x, const chtype *cells, int count);
+    void endFrame();
+    const char *getName() const;
+
+    inline int getFrames() const { return this->frames; }
+    inline long getCells() const { return this->cells; }
+    inline long getSpans() const { return this->spans; }
+};
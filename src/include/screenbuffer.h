@@ -0,0 +1,65 @@
+#pragma once
+
+#include <ncurses.h>
+#include <vector>
+
+class Renderer;
+
+/*
+ * Back buffer of screen cells that only sends the changed cells to a renderer
+ *
+ * Everything is drawn into the back buffer with the same calls as curses.
+ * present() compares it with the frame shown before and only writes the cells
+ * that differ, so the terminal is never cleared and repainted from scratch.
+ * Nothing here calls curses, only its cell & attribute types are used.
+ * Each cell is a chtype, the character with its attributes & color pair.
+ *
+ * Usage:
+ * ScreenBuffer screen(LINES, COLS);
+ * screen.attrOn(COLOR_PAIR(7));
+ * screen.mvAddStr(0, 0, "Hello");
+ * screen.present(renderer); // Writes 5 cells
+ */
+class ScreenBuffer {
+  public:
+    // What a present sent to the terminal
+    struct FrameStats {
+        int cells; // Cells that changed
+        int bytes; // Estimate of the bytes written, escape sequences included
+        int spans; // Runs of cells handed to the renderer
+    };
+
+    // Unchanged cells a run may bridge instead of being split in two
+    static const int MERGE_GAP = 8;
+
+  private:
+    int height;
+    int width;
+    std::vector<chtype> back;  // Frame being drawn
+    std::vector<chtype> front; // Frame on the terminal
+    int cursorY, cursorX;
+    attr_t attr;
+    FrameStats lastFrame;
+
+  public:
+    ScreenBuffer(int height = 0, int width = 0);
+
+    void resize(int height, int width);
+    void erase();
+    void erase(const ScreenBuffer &layer);
+    void invalidate();
+
+    inline int getHeight() const { return this->height; }
+    inline int getWidth() const { return this->width; }
+    inline FrameStats getLastFrame() const { return this->lastFrame; }
+    chtype getCell(int y, int x) const;
+
+    void move(int y, int x);
+    void addStr(const char *text);
+    void mvAddStr(int y, int x, const char *text);
+    void putCells(int y, int x, const chtype *cells, int count);
+    void attrOn(attr_t attrs);
+    void attrOff(attr_t attrs);
+
+    FrameStats present(Renderer &renderer);
+};
@@ -2,6 +2,7 @@
 #include "include/item.h"
 #include "include/enums.h"
 #include "include/player.h"
+#include "include/random.h"
 
 #include <string>
 
@@ -87,19 +88,20 @@ Item::Item(int id, const std::string &name, const std::string &description,
  * Only executed if hasCustomBehavior is set to true.
  * Empty by default — override in derived classes if needed.
  * @param player Reference to the Player object affected by the item
+ * @param rng    Source of randomness of the game session
  */
-void Item::update(Player &player) {
+void Item::update(Player &player, Random &rng) {
     switch (this->id) {
     case ItemID::WornSneakers:
-        if (player.getPrevPos() != player.getPos() && rand() % 10 < 1)
+        if (player.getPrevPos() != player.getPos() && rng.chance(1, 10))
             player.setStamina(player.getStamina() + 1);
         break;
     case ItemID::Wheelchair:
-        if (player.getPrevPos() != player.getPos() && rand() % 4 < 1)
+        if (player.getPrevPos() != player.getPos() && rng.chance(1, 4))
             player.setStamina(player.getStamina() + 1);
         break;
     case ItemID::HermesBoots:
-        if (player.getPrevPos() != player.getPos() && rand() % 10 < 8)
+        if (player.getPrevPos() != player.getPos() && rng.chance(8, 10))
             player.setStamina(player.getStamina() + 1);
         break;
     case ItemID::LitTorch:
@@ -149,7 +151,7 @@ void Item::update(Player &player) {
         }
         break;
     case ItemID::GTCDV2:
-        if(player.getPrevPos() != player.getPos() && rand() % 5 < 1)
+        if(player.getPrevPos() != player.getPos() && rng.chance(1, 5))
             player.setStamina(player.getStamina() + 3);
         break;
     }
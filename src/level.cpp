@@ -1,164 +1,167 @@
 #include "include/level.h"
 #include "include/enums.h"
+#include "include/profiler.h"
 #include "include/vector2d.h"
-#include <stdlib.h>
+#include <algorithm>
+#include <cstdlib>
 #include <unistd.h>
+#include <unordered_set>
 #include <vector>
 
 /*
  * Constructor for the Level class
- * Generates a maze using Prim's algorithm, places the exit, and spawns items.
+ * Generates a maze with the default generator, Randomized Prim's, places the
+ * exit, and spawns items. The game picks the algorithm per difficulty and
+ * uses the overload that takes a MazeGenerator.
  *
  * @param size       Size of the square maze (size x size)
  * @param startPos   Starting position for the maze generation and player
  * @param itemCount  Number of items to randomly place in the maze
+ * @param seed       Seed of the level, the same seed gives the same level
  * @return none
  */
-Level::Level(int size, Vector2D startPos, int itemCount) {
-    this->size = size;
-    this->maze = TileMap(size, std::vector<TileObject>(size, TileObject::Wall));
-    this->wallList = std::vector<Vector2D>();
-    this->startPos = startPos;
-    this->itemCount = itemCount;
-    // Run the generation algorithm
-    generateMaze(startPos);
-    // Set starting position to player
-    // this->maze[startPos.y][startPos.x] = TileObject::Player;
-    setExit();
-    placeItems(itemCount);
+Level::Level(int size, Vector2D startPos, int itemCount, uint64_t seed)
+    : rng(seed), generationTime(0) {
+    PrimGenerator generator;
+    build(size, startPos, itemCount, generator);
 }
 
 /*
- * Function to generate a maze of pre-determined size with given starting point
- * Uses Iterative Randomized Prim's Algorithm
+ * Constructor for the Level class
+ * Generates a maze with whichever generator is passed in, places the exit,
+ * and spawns items.
  *
- * Args: starting position
+ * @param size       Size of the square maze (size x size)
+ * @param startPos   Starting position for the maze generation and player
+ * @param itemCount  Number of items to randomly place in the maze
+ * @param generator  Algorithm used to carve the maze
+ * @param seed       Seed of the level, the same seed gives the same level
+ * @return none
  */
-void Level::generateMaze(Vector2D pos) {
-#pragma region Starting Cell
-    this->maze[pos.y][pos.x] = TileObject::None;
-    getAdjWalls(pos);
-#pragma endregion
-
-    // While there are walls to be checked/removed, do Prim's algorithm
-    while (this->wallList.size() > 0 || pos == this->startPos) {
-        // Get random wall to verify
-        int index = int(rand() % this->wallList.size());
-        pos = this->wallList[index];
-
-        // Check if chosen wall is connected to too many empty tiles
-        if (verifyWall(pos)) {
-            // Remove wall
-            this->maze[pos.y][pos.x] = TileObject::None;
-            getAdjWalls(pos);
-        }
-
-        // Remove any checked wall from the list of unchecked walls
-        wallList.erase(wallList.begin() + index);
-    }
+Level::Level(int size, Vector2D startPos, int itemCount,
+             MazeGenerator &generator, uint64_t seed)
+    : rng(seed), generationTime(0) {
+    build(size, startPos, itemCount, generator);
 }
 
 /*
- * Function to find all walls next to given position
- * Any wall found will be added to the list of walls
+ * Empty level, filled in by Level::chunked
+ */
+Level::Level()
+    : itemCount(0), size(0), gameStatus(false), generationTime(0) {}
+
+/*
+ * Creates a level with chunked storage
+ * Nothing is generated up front: chunks are carved when first read and the
+ * least recently used ones are dropped once more than maxChunks are loaded.
+ * The exit & items go on cells, which are always open, so placing them
+ * doesn't generate anything either.
  *
- * Args: position to check
+ * Usage:
+ * Level level = Level::chunked(20001, Vector2D(0, 0), 40, type, seed);
  *
+ * @param size      Size of the square maze (size x size)
+ * @param startPos  Starting position of the player, on even coordinates
+ * @param itemCount Number of items to randomly place in the maze
+ * @param type      Generator used to carve each chunk
+ * @param seed      Seed of the level, the same seed gives the same level
+ * @param maxChunks Number of chunks kept in memory
+ * @return Level
  */
-void Level::getAdjWalls(Vector2D pos) {
-    // Check above
-    if (pos.y > 0 && this->maze[pos.y - 1][pos.x] == TileObject::Wall)
-        this->wallList.push_back(Vector2D(pos.y - 1, pos.x));
-
-    // Check left
-    if (pos.x > 0 && this->maze[pos.y][pos.x - 1] == TileObject::Wall)
-        this->wallList.push_back(Vector2D(pos.y, pos.x - 1));
-
-    // Check below
-    if (pos.y < this->size - 1 &&
-        this->maze[pos.y + 1][pos.x] == TileObject::Wall)
-        this->wallList.push_back(Vector2D(pos.y + 1, pos.x));
-
-    // Check right
-    if (pos.x < this->size - 1 &&
-        this->maze[pos.y][pos.x + 1] == TileObject::Wall)
-        this->wallList.push_back(Vector2D(pos.y, pos.x + 1));
+Level Level::chunked(int size, Vector2D startPos, int itemCount,
+                     GeneratorType type, uint64_t seed, int maxChunks) {
+    Level level;
+    level.rng = Random(seed);
+    level.chunks.reset(new ChunkMap(size, type, seed, maxChunks));
+    level.size = size;
+    level.startPos = startPos;
+    level.itemCount = itemCount;
+    {
+        PROFILE_SCOPE(level.generationTime);
+        level.placeChunked();
+    }
+    return level;
 }
 
 /*
- * Function to verify if a wall can be removed
- * A wall can only be removed if it is connected to no more than 1 empty tiles
+ * Shared body of the constructors, carves the maze and places the exit &
+ * items
  *
- * Assumption: only walls next to at least one empty tile can exist in the list
- * of walls
- *
- * Args: position of wall to verify
- *
- * Return: if the wall can be removed or not
+ * @return void
  */
-bool Level::verifyWall(Vector2D wallPos) {
-    int count = 0;
-    // Check up
-    if (wallPos.y > 0 &&
-        this->maze[wallPos.y - 1][wallPos.x] == TileObject::None)
-        count++;
-
-    // Check left
-    if (wallPos.x > 0 &&
-        this->maze[wallPos.y][wallPos.x - 1] == TileObject::None)
-        count++;
-
-    // Check down
-    if (wallPos.y < this->size - 1 &&
-        this->maze[wallPos.y + 1][wallPos.x] == TileObject::None)
-        count++;
-
-    // Check right
-    if (wallPos.x < this->size - 1 &&
-        this->maze[wallPos.y][wallPos.x + 1] == TileObject::None)
-        count++;
-
-    return count == 1;
+void Level::build(int size, Vector2D startPos, int itemCount,
+                  MazeGenerator &generator) {
+    PROFILE_SCOPE(this->generationTime);
+    this->size = size;
+    this->maze = TileMap(size, size, TileObject::Wall, TileObject::Border);
+    this->startPos = startPos;
+    this->itemCount = itemCount;
+    // Run the generation algorithm
+    generator.generate(this->maze, startPos, this->rng);
+    // Set starting position to player
+    // this->maze[startPos.y][startPos.x] = TileObject::Player;
+    computeDistances();
+    setExit();
+    placeItems(itemCount);
 }
 
 /*
- * Selects and marks an exit point in the maze
- * Filters out tiles that are too close to the start, then randomly chooses
- * one of the remaining path tiles to serve as the exit.
+ * Computes the path distance of every tile from the start with a BFS
+ * The visited tiles are kept in pathTiles, which doubles as the BFS queue.
+ * Walls broken later with a pickaxe aren't taken into account.
  *
  * @return void
  */
-void Level::setExit() {
-    std::vector<Vector2D> tileList = std::vector<Vector2D>();
-    Vector2D pos;
-    for (int i = 0; i < this->size; i++) {
-        for (int j = 0; j < this->size; j++) {
-            pos = Vector2D(i, j);
-            if (this->maze[i][j] == TileObject::None) {
-                if (std::abs(startPos.y - i) + std::abs(startPos.x - j) <
-                    this->size)
-                    continue;
-                tileList.push_back(pos);
-            }
+void Level::computeDistances() {
+    this->distances = Grid<int>(this->size, this->size, -1, -1);
+    this->pathTiles.clear();
+    if (this->maze[this->startPos] != TileObject::None)
+        return;
+    // The maze & the distances have the same layout, so one index reads both
+    const TileObject *tiles = &this->maze(-1, -1);
+    int *dist = &this->distances(-1, -1);
+    int stride = this->maze.getStride();
+    int offsets[] = {-stride, -1, stride, 1};
+    Vector2D dirs[] = {Vector2D(-1, 0), Vector2D(0, -1), Vector2D(1, 0),
+                       Vector2D(0, 1)};
+    this->pathTiles.reserve(std::size_t(this->size) * this->size / 2 + 1);
+    this->distances[this->startPos] = 0;
+    this->pathTiles.push_back(this->startPos);
+    for (std::size_t head = 0; head < this->pathTiles.size(); head++) {
+        Vector2D pos = this->pathTiles[head];
+        std::size_t index = this->maze.indexOf(pos.y, pos.x);
+        int next = dist[index] + 1;
+        for (int i = 0; i < 4; i++) {
+            std::size_t adj = index + offsets[i];
+            // The border ring is never None, so no bounds checks are needed
+            if (tiles[adj] != TileObject::None || dist[adj] != -1)
+                continue;
+            dist[adj] = next;
+            this->pathTiles.push_back(pos + dirs[i]);
         }
     }
-    pos = tileList[int(rand() % tileList.size())];
-    this->maze[pos.y][pos.x] = TileObject::Exit;
-    this->endPos = pos;
 }
 
-#pragma region RNG Helper
-std::vector<Vector2D> getRandPaths(std::vector<Vector2D> &pathList, int count) {
-    std::vector<Vector2D> selectedTiles;
-    int index;
-    for (int i = 0; i < count; i++) {
-        index = rand() % (int)pathList.size();
-        selectedTiles.push_back(pathList[index]);
-        pathList.erase(pathList.begin() + index);
-    }
-    return selectedTiles;
+/*
+ * Selects and marks an exit point in the maze
+ * Randomly chooses one of the path tiles whose path distance from the start
+ * is at least the size of the maze and half of the longest path. Small mazes
+ * may have no tile that far, then the farthest ones are used.
+ *
+ * @return void
+ */
+void Level::setExit() {
+    int maxDist = getMaxDistance();
+    int minDist = std::min(std::max(this->size, maxDist / 2), maxDist);
+    // pathTiles is sorted by distance, so the candidates are a suffix of it
+    std::vector<Vector2D>::const_iterator first = std::lower_bound(
+        this->pathTiles.begin(), this->pathTiles.end(), minDist,
+        [this](Vector2D pos, int dist) { return this->distances[pos] < dist; });
+    int count = int(this->pathTiles.end() - first);
+    Vector2D pos = first[this->rng.nextInt(count)];
+    this->maze(pos.y, pos.x) = TileObject::Exit;
+    this->endPos = pos;
 }
-#pragma endregion
 
 /*
  * Function to put a given amount of random items in random spots of the maze
@@ -166,39 +169,72 @@ std::vector<Vector2D> getRandPaths(std::vector<Vector2D> &pathList, int count) {
  * Args: number of items to put
  */
 void Level::placeItems(int count) {
+    // Path tiles away from the start row & column, the exit is excluded
+    std::vector<Vector2D> selectedTiles = this->rng.sample(
+        this->pathTiles, count, [this](Vector2D pos) {
+            return this->maze[pos] == TileObject::None && pos.y > 0 &&
+                   pos.x > 0;
+        });
+
+    for (std::size_t i = 0; i < selectedTiles.size(); i++) {
+        Vector2D pos = selectedTiles[i];
+        this->maze(pos.y, pos.x) = rollItem(int(i));
+    }
+}
+
+/*
+ * Picks the item placed on the index-th selected tile
+ * Fixed 1 of each collectable first, then weighted randomization
+ *
+ * @param index Index of the tile among the selected ones
+ * @return TileObject
+ */
+TileObject Level::rollItem(int index) {
     TileObject items[] = {TileObject::Ration, TileObject::EnergyDrink,
                           TileObject::Chest, TileObject::Pickaxe};
     int weights[] = {50, 25, 10, 15};
+    if (index < 4)
+        return items[index];
 
-    std::vector<Vector2D> pathList = std::vector<Vector2D>();
-    for (int i = 0; i < this->size; i++)
-        for (int j = 0; j < this->size; j++)
-            if (this->maze[i][j] == TileObject::None && i > 0 && j > 0)
-                pathList.push_back(Vector2D(i, j));
-    
-    std::vector<Vector2D> selectedTiles = getRandPaths(pathList, count);
-
-    // Fixed 1 of each of collectable
-    for(int i = 0; i < 4; i++) {
-        Vector2D pos = selectedTiles[i];
-        this->maze[pos.y][pos.x] = items[i];
+    int rnd = this->rng.nextInt(100);
+    for (int i = 0; i < 4; i++) {
+        rnd -= weights[i];
+        if (rnd <= 0)
+            return items[i];
     }
-    selectedTiles.erase(selectedTiles.begin(), selectedTiles.begin() + 4);
-    if (count <= 4)
-        return;
-        
-    // Weighted randomization after placing 1 of each collectable 
-    for (auto pos : selectedTiles) {
-        TileObject item = TileObject::None;
-        int rnd = rand() % 100;
-        for (int i = 0; i < 4; i++) {
-            rnd -= weights[i];
-            if (rnd <= 0) {
-                item = items[i];
-                break;
-            }
-        }
-        this->maze[pos.y][pos.x] = item;
+    return TileObject::None;
+}
+
+/*
+ * Places the exit & items of a chunked level on random cells
+ * The exit goes in the last chunk, the farthest one from a start in the top
+ * left corner. Items avoid the start row & column like in placeItems.
+ *
+ * @return void
+ */
+void Level::placeChunked() {
+    int last = (this->size - 1) / ChunkMap::CHUNK_SIZE * ChunkMap::CHUNK_SIZE;
+    int lastCells = (this->size - last + 1) / 2;
+    std::unordered_set<int64_t> taken;
+    taken.insert(int64_t(this->startPos.y) * this->size + this->startPos.x);
+    do {
+        this->endPos = Vector2D(last + 2 * this->rng.nextInt(lastCells),
+                                last + 2 * this->rng.nextInt(lastCells));
+    } while (this->endPos == this->startPos);
+    taken.insert(int64_t(this->endPos.y) * this->size + this->endPos.x);
+    this->chunks->set(this->endPos.y, this->endPos.x, TileObject::Exit);
+
+    // Cells with y > 0 & x > 0, rerolled if already taken
+    int cells = (this->size - 1) / 2;
+    int count = int(std::min<int64_t>(this->itemCount,
+                                      int64_t(cells) * cells - 1));
+    for (int i = 0; i < count; i++) {
+        Vector2D pos;
+        do {
+            pos = Vector2D(2 + 2 * this->rng.nextInt(cells),
+                           2 + 2 * this->rng.nextInt(cells));
+        } while (!taken.insert(int64_t(pos.y) * this->size + pos.x).second);
+        this->chunks->set(pos.y, pos.x, rollItem(i));
     }
 }
 
@@ -210,11 +246,68 @@ void Level::placeItems(int count) {
 int Level::getSize() const { return this->size; }
 
 /*
- * Gets the current state of the maze
+ * Gets a copy of the current state of the maze
+ * Copies the whole grid, use getView to read tiles instead
+ *
+ * @return TileMap Grid representing maze tiles
+ */
+TileMap Level::getMaze() const {
+    if (!this->chunks)
+        return this->maze;
+    // Chunked levels are put together tile by tile, which loads every chunk
+    TileMap maze(this->size, this->size, TileObject::Wall, TileObject::Border);
+    for (int y = 0; y < this->size; y++)
+        for (int x = 0; x < this->size; x++)
+            maze(y, x) = this->chunks->get(y, x);
+    return maze;
+}
+
+/*
+ * Gets a view of the whole maze, without copying it
+ * The border ring can be read through it too, at -1 and size
+ *
+ * @return TileView Empty for chunked levels, which are never whole
+ */
+TileView Level::getView() const {
+    if (this->chunks)
+        return TileView();
+    return this->maze.view();
+}
+
+/*
+ * Gets a view of a rectangle of the maze
+ * Dense levels point straight into the maze. Chunked levels copy the tiles
+ * into a buffer that is reused, so the view is valid until the next call.
+ *
+ * Assumption: the rectangle is inside the maze & its border ring
+ *
+ * @param top    Row of the top left tile, from -1
+ * @param left   Column of the top left tile, from -1
+ * @param height Number of rows
+ * @param width  Number of columns
+ * @return TileView
+ */
+TileView Level::getView(int top, int left, int height, int width) const {
+    if (!this->chunks)
+        return this->maze.view(top, left, height, width);
+    this->viewBuffer.resize(std::size_t(height) * width);
+    TileObject *tiles = this->viewBuffer.data();
+    for (int y = 0; y < height; y++)
+        for (int x = 0; x < width; x++)
+            *tiles++ = this->chunks->get(top + y, left + x);
+    return TileView(this->viewBuffer.data(), height, width, width);
+}
+
+/*
+ * Gets the tiles of a row of the maze
  *
- * @return TileMap 2D vector representing maze tiles
+ * @param y Row to read, from 0 to size - 1
+ * @return const TileObject* Pointer to size tiles, see getView for how long
+ *         it stays valid on chunked levels
  */
-TileMap Level::getMaze() const { return this->maze; }
+const TileObject *Level::getRow(int y) const {
+    return getView(y, 0, 1, this->size).row(0);
+}
 
 /*
  * Gets the player's starting position in the maze
@@ -237,6 +330,55 @@ Vector2D Level::getEnd() const { return this->endPos; }
  */
 bool Level::getGameStatus() const { return this->gameStatus; }
 
+/*
+ * Gets how long generating the level took, for chunked levels it also counts
+ * the chunks preloaded so far
+ *
+ * @return double Milliseconds, 0 when the profiler is compiled out
+ */
+double Level::getGenerationTime() const { return this->generationTime; }
+
+/*
+ * Gets the path distance of a tile from the start, as generated
+ *
+ * Assumption: the position is at most one tile outside of the maze
+ *
+ * @param pos Position of the tile
+ * @return int Number of steps from the start, -1 if it can't be reached
+ */
+int Level::getDistance(Vector2D pos) const {
+    if (this->chunks)
+        return -1;
+    return this->distances[pos];
+}
+
+/*
+ * Gets the length of the longest shortest path from the start
+ *
+ * @return int Distance of the farthest reachable tile
+ */
+int Level::getMaxDistance() const {
+    if (this->pathTiles.empty())
+        return 0;
+    return this->distances[this->pathTiles.back()];
+}
+
+/*
+ * Gets the distance field of the level, for hints & solvers
+ *
+ * @return const Grid<int>& Path distance of every tile, -1 if unreachable
+ */
+const Grid<int> &Level::getDistances() const { return this->distances; }
+
+/*
+ * Gets the reachable path tiles of the generated maze
+ *
+ * @return const std::vector<Vector2D>& Tiles in order of distance
+ */
+const std::vector<Vector2D> &Level::getPathTiles() const {
+    return this->pathTiles;
+}
+
 /*
  * Checks if a given move is valid (not out of bounds or a wall)
  *
@@ -244,14 +386,8 @@ bool Level::getGameStatus() const { return this->gameStatus; }
  * @return bool True if move is valid, false otherwise
  */
 bool Level::isValidMove(Vector2D playerPos) const {
-    if (playerPos.x < 0 || playerPos.x >= this->size || playerPos.y < 0 ||
-        playerPos.y >= this->size)
-        return false;
-
-    if (this->maze[playerPos.y][playerPos.x] == TileObject::Wall)
-        return false;
-
-    return true;
+    TileObject tile = getTile(playerPos);
+    return tile != TileObject::Wall && tile != TileObject::Border;
 }
 
 /*
@@ -262,18 +398,71 @@ bool Level::isValidMove(Vector2D playerPos) const {
  * @return void
  */
 void Level::setTile(Vector2D pos, TileObject target) {
-    this->maze[pos.y][pos.x] = target;
+    TileObject previous = getTile(pos);
+    bool wasOpaque =
+        previous == TileObject::Wall || previous == TileObject::Border;
+    bool isOpaque = target == TileObject::Wall || target == TileObject::Border;
+    if (wasOpaque != isOpaque)
+        this->sight.invalidate(pos);
+
+    if (this->chunks)
+        this->chunks->set(pos.y, pos.x, target);
+    else
+        this->maze[pos] = target;
+}
+
+/*
+ * Gets the tiles in line of sight of a position, walls block sight
+ * The result is cached until a wall within the radius changes
+ *
+ * @param pos    Position to look from
+ * @param radius How far sight reaches
+ * @return const Sight& Visible tiles as offsets from pos
+ */
+const Sight &Level::getSight(Vector2D pos, int radius) const {
+    return this->sight.get(*this, pos, radius);
 }
 
 /*
  * Gets the tile object at a specific position in the maze
  *
  * @param pos Position of the tile to retrieve
- * @return TileObject The tile object at the specified position
+ * @return TileObject The tile object at the specified position, Border if it
+ * is outside of the maze
  */
 TileObject Level::getTile(Vector2D pos) const {
     if (pos.x < 0 || pos.x >= this->size || pos.y < 0 || pos.y >= this->size)
-        return TileObject::None;
+        return TileObject::Border;
+
+    // Loading a chunk doesn't change the level, only what is cached
+    if (this->chunks)
+        return this->chunks->get(pos.y, pos.x);
+    return this->maze[pos];
+}
 
-    return this->maze[pos.y][pos.x];
+/*
+ * Checks if the level uses chunked storage
+ *
+ * @return bool
+ */
+bool Level::isChunked() const { return this->chunks != nullptr; }
+
+/*
+ * Loads the chunks around a position before they are drawn, does nothing
+ * for levels that aren't chunked. Chunks carved here count towards the
+ * generation time.
+ *
+ * @param pos    Position of the player
+ * @param radius Distance from the player to the edge of the view
+ * @return void
+ */
+void Level::preload(Vector2D pos, int radius) {
+    if (!this->chunks)
+        return;
+    double time = 0;
+    {
+        PROFILE_SCOPE(time);
+        this->chunks->preload(pos, radius);
+    }
+    this->generationTime += time;
 }
@@ -1,14 +1,21 @@
 ﻿#include "include/config.h"
+#include "include/configwatcher.h"
 #include "include/display.h"
 #include "include/enums.h"
+#include "include/generator.h"
 #include "include/level.h"
 #include "include/player.h"
+#include "include/prefetch.h"
+#include "include/profiler.h"
+#include "include/random.h"
 #include "include/vector2d.h"
 
 #include <assert.h>
+#include <chrono>
 #include <cmath>
 #include <cstdlib>
 #include <cstring>
+#include <deque>
 #include <ctime>
 #include <fstream>
 #include <iostream>
@@ -31,6 +38,9 @@
 
 class Main {
   private:
+    // When the game was started, to time how long the main menu takes
+    std::chrono::steady_clock::time_point startTime;
+    bool menuShown = false;
     GameState gamestate;
     Player player;
     int currentMapSize = 5;
@@ -47,9 +57,16 @@ class Main {
     int selectedItemID;
 
     Difficulty difficulty;
+    Random rng; // Randomness of the game session, also seeds every level
     Level currentLevel;
+    uint64_t nextLevelSeed; // Seed of the next level, drawn ahead for prefetch
+    LevelPrefetcher prefetcher;
     KeyInput lastDirectionalInput;
-    Config config;
+    Config &config; // Shared with the rest of the game
+    std::deque<KeyInput> queuedKeys; // Read but not played yet
+    // Where frames go, from RENDER_BACKEND when the game started
+    RendererType rendererType = RendererType::Curses;
+    ConfigWatcher watcher; // Sees edits of the config made while playing
 
     std::vector<std::vector<std::unique_ptr<Item> > > unobtainedItems;
 
@@ -85,11 +102,13 @@ class Main {
         std::cout << "Opening config with: " << command << std::endl;
         system(command.c_str());
 
-        // Restore ncurses
+        // Restore ncurses, which also brings back the curses renderer
         Display::initCurses();
+        selectRenderer();
 
         // Reload config
-        config = Config();
+        if (config.reloadIfChanged())
+            applyConfig();
     }
 
   public:
@@ -98,15 +117,21 @@ class Main {
      * Sets up the first level with default parameters.
      *
      * Usage:
-     * Main game;
+     * Main game(seed);
+     *
+     * @param seed Seed of the game session
      */
-    Main() : currentLevel(currentMapSize, Vector2D(0, 0), 4) {
+    Main(uint64_t seed)
+        : startTime(std::chrono::steady_clock::now()), rng(seed),
+          currentLevel(currentMapSize, Vector2D(0, 0), 4, rng.next()),
+          nextLevelSeed(rng.next()),
+          prefetcher(Config::getShared().getInt(Config::THREADS) > 0),
+          config(Config::getShared()),
+          watcher(Config::getShared().getConfigFilePath()) {
         gamestate = GameState::MainMenu;
         player = Player();
         player.setPos(0, 0);
 
-        config = Config();
-
         utils::loadItems(unobtainedItems);
     }
 
@@ -118,70 +143,208 @@ class Main {
      */
 #pragma region GET INPUT
     KeyInput getInput() { // TODO: Make it modular and configurable
-        char inp = getch();
+        // Show the frame before waiting, getch would only show stdscr. While
+        // keys queue up faster than the frame cap, frames are skipped.
+        if (Display::isFrameDue() ||
+            (queuedKeys.empty() && !hasQueuedInput()))
+            Display::present();
+        if (!menuShown && gamestate == GameState::MainMenu) {
+            menuShown = true;
+            double ms = std::chrono::duration<double, std::milli>(
+                            std::chrono::steady_clock::now() - startTime)
+                            .count();
+            PROFILE_TIME(Profiler::Startup, ms);
+        }
+        // Keys drained during a level come first, in the order they came
+        if (!queuedKeys.empty()) {
+            KeyInput next = queuedKeys.front();
+            queuedKeys.pop_front();
+            return next;
+        }
+
+        int inp = getch();
+        PROFILE_INPUT();
+        pollConfig();
 
-        if (inp == KEY_RESIZE) {
-            assert(checkScreenSize());
+        // The next flush follows the new size of the screen
+        if (inp == KEY_RESIZE)
             return KeyInput::None;
-        } else if (inp == config.getConfig(Config::KB_UP)[0]) {
-            return KeyInput::Up;
-        } else if (inp == config.getConfig(Config::KB_DOWN)[0]) {
-            return KeyInput::Down;
-        } else if (inp == config.getConfig(Config::KB_LEFT)[0]) {
-            return KeyInput::Left;
-        } else if (inp == config.getConfig(Config::KB_RIGHT)[0]) {
-            return KeyInput::Right;
-        } else if (inp == config.getConfig(Config::KB_CONFIRM)[0]) {
-            return KeyInput::Confirm;
-        } else if (inp == config.getConfig(Config::KB_CANCEL)[0]) {
-            return KeyInput::Cancel;
-        } else if (inp == config.getConfig(Config::KB_USE_PICKAXE)[0]) {
-            return KeyInput::UsePickaxe;
-        } else if (inp == config.getConfig(Config::KB_USE_RATION)[0]) {
-            return KeyInput::UseRation;
-        } else if (inp == config.getConfig(Config::KB_EXIT)[0]) {
-            return KeyInput::Exit;
-        }
-
-        return KeyInput::None;
+        return config.getKeyInput(inp);
     }
 #pragma enderegion
 
     /*
-     * Function to run when the user completes the current level
-     * Adjusts level size and stamina based on difficulty
+     * Sends the frames to the backend the game started with
+     * Call it after Display::initCurses, which always sets up curses. Other
+     * backends play without showing anything, e.g. to benchmark.
+     *
      * @return void
      */
-#pragma region ON LEVEL COMPLETE
-    void onLevelComplete() {
-        player.setPos(Vector2D(0, 0));
-        completedLevels++;
+    void selectRenderer() {
+        if (rendererType == RendererType::Curses)
+            return;
+        int maxY, maxX;
+        getmaxyx(stdscr, maxY, maxX);
+        Display::setRenderer(Renderer::create(rendererType, maxY, maxX));
+    }
+
+    /*
+     * Applies the settings that can change while the game runs
+     * The seed, threads, backend & intro are only read on start.
+     *
+     * @return void
+     */
+    void applyConfig() {
+        Display::setFrameCap(int(config.getInt(Config::FRAME_CAP)));
+    }
 
+    /*
+     * Reloads the config if it was written since the last poll, e.g. from
+     * another terminal. The game waits for keys in getch, so an edit takes
+     * effect when the next key is read, and that key is already decoded with
+     * the new bindings. Keys queued before the edit keep the old ones.
+     *
+     * @return void
+     */
+    void pollConfig() {
+        if (watcher.poll() && config.reloadIfChanged())
+            applyConfig();
+    }
+
+    /*
+     * Reads every key that is already waiting into queuedKeys, without
+     * waiting for more. Keys that aren't bound are dropped.
+     *
+     * @return void
+     */
+    void drainInput() {
+        pollConfig();
+        nodelay(stdscr, TRUE);
+        for (int inp = getch(); inp != ERR; inp = getch()) {
+            KeyInput next = config.getKeyInput(inp);
+            if (next != KeyInput::None)
+                queuedKeys.push_back(next);
+            PROFILE_INPUT();
+        }
+        nodelay(stdscr, FALSE);
+    }
+
+    /*
+     * Checks if a key is waiting to be read, without waiting for one
+     *
+     * @return bool
+     */
+    bool hasQueuedInput() {
+        nodelay(stdscr, TRUE);
+        int inp = getch();
+        nodelay(stdscr, FALSE);
+        if (inp == ERR)
+            return false;
+        ungetch(inp);
+        return true;
+    }
+
+    /*
+     * Picks the maze generator for the current difficulty
+     * Catacombs keeps Prim's many short dead ends. Labyrinth uses Wilson's
+     * unbiased mazes. Purgatory grows the fastest, so it uses the fastest
+     * generator, whose long winding corridors also make it the hardest.
+     *
+     * @return GeneratorType
+     */
+    GeneratorType getGeneratorType() const {
+        switch (difficulty) {
+        case Difficulty::Labyrinth:
+            return GeneratorType::Wilson;
+        case Difficulty::Purgatory:
+            return GeneratorType::Backtracker;
+        default:
+            return GeneratorType::Prim;
+        }
+    }
+
+    /*
+     * Builds a level with the generator of the current difficulty
+     * Uses the prefetched level if it was built with the same parameters
+     *
+     * @param size      Size of the square maze
+     * @param itemCount Number of items to place
+     * @return Level
+     */
+    Level createLevel(int size, int itemCount) {
+        LevelPrefetcher::Params params = {size, player.getPos(), itemCount,
+                                          getGeneratorType(), nextLevelSeed};
+        Level level = prefetcher.take(params);
+        nextLevelSeed = rng.next();
+        return level;
+    }
+
+    /*
+     * Grows the map size & item count for the next layer
+     *
+     * @param completed Number of completed levels including the current one
+     * @param size      Map size to grow
+     * @param items     Item count to grow
+     * @return double   Stamina multiplier of the difficulty
+     */
+    double growLayer(int completed, int &size, float &items) const {
         double energyMult = 0;
         switch (difficulty) {
         case (Difficulty::Catacombs): // Easy mode
-            if (completedLevels % 2 == 0) {
-                currentMapSize += 2;
+            if (completed % 2 == 0) {
+                size += 2;
             }
-            itemCount += 1.5f;
+            items += 1.5f;
             energyMult = 0.75;
             break;
         case (Difficulty::Labyrinth): // Medium mode
-            currentMapSize += 2;
-            itemCount += 1.0f;
+            size += 2;
+            items += 1.0f;
             energyMult = 0.55;
             break;
         case (Difficulty::Purgatory): // Hard mode
-            currentMapSize += 3;
-            itemCount += 0.75f;
+            size += 3;
+            items += 0.75f;
             energyMult = 0.4;
             break;
         }
         if (player.hasItem(ItemID::GTCDV1))
-            itemCount += 2;
+            items += 2;
+        return energyMult;
+    }
 
-        currentLevel =
-            Level(currentMapSize, player.getPos(), int(std::floor(itemCount)));
+    /*
+     * Starts building the next layer in the background
+     * If the player picks up something that changes it (e.g. GTCDV1), the
+     * parameters won't match and createLevel builds it synchronously instead
+     *
+     * @return void
+     */
+    void prefetchNextLevel() {
+        int size = currentMapSize;
+        float items = itemCount;
+        growLayer(completedLevels + 1, size, items);
+        LevelPrefetcher::Params params = {size, Vector2D(0, 0),
+                                          int(std::floor(items)),
+                                          getGeneratorType(), nextLevelSeed};
+        prefetcher.request(params);
+    }
+
+    /*
+     * Function to run when the user completes the current level
+     * Adjusts level size and stamina based on difficulty
+     * @return void
+     */
+#pragma region ON LEVEL COMPLETE
+    void onLevelComplete() {
+        player.setPos(Vector2D(0, 0));
+        completedLevels++;
+
+        double energyMult =
+            growLayer(completedLevels, currentMapSize, itemCount);
+
+        currentLevel = createLevel(currentMapSize, int(std::floor(itemCount)));
+        prefetchNextLevel();
         auto newStamina = int(player.getStamina() +
                               std::floor(player.getStaminaMax() * energyMult));
 
@@ -207,7 +370,8 @@ class Main {
         itemCount = 4.0f;
         // if (difficulty == Difficulty::Purgatory)
         //     itemCount -= 1;
-        currentLevel = Level(currentMapSize, player.getPos(), int(itemCount));
+        currentLevel = createLevel(currentMapSize, int(itemCount));
+        prefetchNextLevel();
     }
 
     /*
@@ -249,6 +413,8 @@ class Main {
             }
             break;
         }
+        case TileObject::Border: // The border ring is never walked on
+            break;
         case TileObject::Chest:
             if (player.getItemCount() >= 5)
                 break;
@@ -267,7 +433,7 @@ class Main {
                 break;
             }
             // Select a non-empty item list
-            int rarity, weights[] = {50, 30, 15, 5}, rnd;
+            int rarity = 0, weights[] = {50, 30, 15, 5}, rnd;
             if (player.hasItem(ItemID::MetalDetector)) {
                 weights[0] = 40;
                 weights[1] = 33;
@@ -275,7 +441,7 @@ class Main {
                 weights[3] = 7;
             }
             do {
-                rnd = rand() % 100;
+                rnd = rng.nextInt(100);
                 for (int i = 0; i < 4; i++) {
                     rnd -= weights[i];
                     if (rnd <= 0) {
@@ -286,7 +452,7 @@ class Main {
             } while (unobtainedItems[rarity].empty());
 
             auto &itemList = unobtainedItems[rarity];
-            int itemIndex = rand() % itemList.size();
+            int itemIndex = rng.nextInt(int(itemList.size()));
             collectedItemName = itemList[itemIndex]->name;
             player.addItem(itemList[itemIndex], itemList);
             currentLevel.setTile(pos, TileObject::None);
@@ -334,6 +500,7 @@ class Main {
             currentLevel.setTile(player.getPos(), TileObject::Ink);
 
         player.setPos(newPos);
+        currentLevel.preload(newPos, LevelPrefetcher::PRELOAD_RADIUS);
 
         if (currentLevel.getTile(newPos) == TileObject::Exit) {
             onLevelComplete();
@@ -377,7 +544,7 @@ class Main {
 
             if (tile == TileObject::Wall) {
                 currentLevel.setTile(newPos, TileObject::None);
-                if(player.hasItem(ItemID::MiningHelmet) && rand() % 2 < 1)
+                if(player.hasItem(ItemID::MiningHelmet) && rng.chance(1, 2))
                     return;
                 player.setPickaxesOwned(player.getPickaxesOwned() - 1);
             }
@@ -401,7 +568,7 @@ class Main {
                      player.getStaminaMax());
 
         player.setStamina(newStamina);
-        if (player.hasItem(ItemID::BlueCheese) && rand() % 10 < 2)
+        if (player.hasItem(ItemID::BlueCheese) && rng.chance(2, 10))
             return;
 
         player.setRationsOwned(player.getRationsOwned() - 1);
@@ -542,18 +709,38 @@ class Main {
         // collectedItemName);
 
         player.preUpdate();
-        player.update();
+        player.update(rng);
 
         Display::drawLevel(currentLevel, player, completedLevels,
                            collectedItemName, lastDirectionalInput);
 
         key = getInput();
+        // Keys that queued up behind it, e.g. from holding a direction, are
+        // all played before the next frame, so it is drawn once for all
+        drainInput();
+        int level = completedLevels;
+        while (applyLevelInput(key) && !queuedKeys.empty() &&
+               completedLevels == level) {
+            key = queuedKeys.front();
+            queuedKeys.pop_front();
+            player.preUpdate();
+            player.update(rng);
+        }
+    }
+
+    /*
+     * Plays one key of a level, a full step of the game
+     *
+     * @param key Key input
+     * @return bool False if the player left the level, e.g. to pause
+     */
+    bool applyLevelInput(KeyInput key) {
         // Check for key press
         if (key == KeyInput::Exit) {
             gamestate = GameState::PauseMenu;
             highlighted = 0;
             confirmed = false;
-            return;
+            return false;
         }
         if (key == KeyInput::Up || key == KeyInput::Down ||
             key == KeyInput::Left || key == KeyInput::Right) {
@@ -562,11 +749,14 @@ class Main {
             breakWall();
         else if (key == KeyInput::UseRation)
             useRation();
+        else if (key == KeyInput::ToggleOverlay)
+            Display::toggleOverlay();
 
         if (player.getStamina() <= 0)
             gamestate = GameState::GameOverMenu;
 
         player.postUpdate();
+        return gamestate == GameState::InLevel;
     }
     /*
      * Handles logic for the inventory menu
@@ -711,11 +901,19 @@ class Main {
      * Game is not updated at all if no valid player input is detected
      * Otherwise, perform an action according to current gamestate & key input
      *
+     * @param showIntro Whether to play the intro before the main menu
      * @return void
      */
-    void runGame() {
+    void runGame(bool showIntro = true) {
+        const std::string &backend = config.getString(Config::RENDER_BACKEND);
+        rendererType = backend == "null"          ? RendererType::Null
+                       : backend == "framebuffer" ? RendererType::Framebuffer
+                                                  : RendererType::Curses;
         Display::initCurses();
-        Display::drawIntro();
+        selectRenderer();
+        applyConfig();
+        if (showIntro)
+            Display::drawIntro();
 
         while (running) {
             switch (gamestate) {
@@ -764,10 +962,25 @@ class Main {
 };
 
 // DRIVER CODE //
-int main() {
-    srand(time(NULL));
+// Usage: game [--no-intro]
+int main(int argc, char **argv) {
+    Config &config = Config::getShared();
+    bool showIntro = config.getBool(Config::SHOW_INTRO);
+    for (int i = 1; i < argc; i++) {
+        if (std::string(argv[i]) == "--no-intro") {
+            showIntro = false;
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--no-intro]" << std::endl;
+            return 1;
+        }
+    }
+
+    uint64_t seed = uint64_t(config.getInt(Config::SEED));
+    Main game(seed != 0 ? seed : uint64_t(time(NULL)));
+    game.runGame(showIntro);
 
-    Main game = Main();
-    game.runGame();
+    // Reported once curses is gone, so they stay on the terminal
+    for (const std::string &problem : config.getProblems())
+        std::cerr << problem << std::endl;
     return 0;
 }
@@ -0,0 +1,174 @@
+#include "include/mazestream.h"
+#include "include/enums.h"
+#include <algorithm>
+#include <cstring>
+
+/*
+ * Copies a streamed row into the matching row of the tile map
+ *
+ * @param y     Row index
+ * @param row   Tiles of the row
+ * @param width Number of tiles in the row
+ * @return void
+ */
+void GridSink::consumeRow(int y, const TileObject *row, int width) {
+    std::memcpy(this->maze.row(y), row, width * sizeof(TileObject));
+}
+
+/*
+ * Writes a streamed row as one line of text
+ *
+ * @param y     Row index
+ * @param row   Tiles of the row
+ * @param width Number of tiles in the row
+ * @return void
+ */
+void FileSink::consumeRow(int y, const TileObject *row, int width) {
+    this->line.assign(width, ' ');
+    for (int x = 0; x < width; x++)
+        if (row[x] == TileObject::Wall)
+            this->line[x] = '#';
+    this->out << this->line << '\n';
+}
+
+/*
+ * Constructor for the streaming Eller's generator
+ *
+ * @param height Number of tile rows to emit, can be far larger than what
+ *               fits in memory
+ * @param width  Number of tiles per row
+ * @param start  Starting position, decides the parity of the cells
+ * @param rng    Source of randomness
+ * @param sink   Receives every row once, from top to bottom
+ */
+EllerStream::EllerStream(int height, int width, Vector2D start, Random &rng,
+                         RowSink &sink)
+    : sink(sink), rng(rng), height(height), width(width), offsetY(start.y % 2),
+      offsetX(start.x % 2), cellRow(0), tileRow(0) {
+    this->rows = std::max(0, (height - offsetY + 1) / 2);
+    this->cols = std::max(0, (width - offsetX + 1) / 2);
+
+    this->sets.assign(cols, -1);
+    this->parent.resize(cols);
+    this->remap.resize(cols);
+    this->members.resize(cols);
+    this->picked.resize(cols);
+    this->goesDown.resize(cols);
+    this->down.resize(cols);
+    this->cellTiles.resize(width);
+    this->passageTiles.resize(width);
+    this->wallTiles.assign(width, TileObject::Wall);
+}
+
+/*
+ * Finds the root of a set label, halving the path on the way
+ */
+int EllerStream::findSet(int label) {
+    while (this->parent[label] != label) {
+        this->parent[label] = this->parent[this->parent[label]];
+        label = this->parent[label];
+    }
+    return label;
+}
+
+/*
+ * Carves the next row of cells
+ * Adjacent cells of different sets are randomly joined, then every set
+ * continues to the next row through at least one cell. The last row joins
+ * every remaining set.
+ *
+ * @return void
+ */
+void EllerStream::carveRow() {
+    int cols = this->cols;
+    bool lastRow = this->cellRow == this->rows - 1;
+
+    // Relabel the sets to 0..n-1 and give new cells their own set
+    std::fill(remap.begin(), remap.end(), -1);
+    int labels = 0;
+    for (int col = 0; col < cols; col++)
+        if (sets[col] != -1 && remap[sets[col]] == -1)
+            remap[sets[col]] = labels++;
+    for (int col = 0; col < cols; col++)
+        sets[col] = sets[col] == -1 ? labels++ : remap[sets[col]];
+    for (int label = 0; label < cols; label++)
+        parent[label] = label;
+
+    std::fill(cellTiles.begin(), cellTiles.end(), TileObject::Wall);
+    std::fill(passageTiles.begin(), passageTiles.end(), TileObject::Wall);
+    for (int col = 0; col < cols; col++)
+        cellTiles[offsetX + col * 2] = TileObject::None;
+
+    // Join adjacent cells of different sets
+    for (int col = 0; col < cols - 1; col++) {
+        int a = findSet(sets[col]);
+        int b = findSet(sets[col + 1]);
+        if (a != b && (lastRow || this->rng.nextInt(2) == 0)) {
+            parent[b] = a;
+            cellTiles[offsetX + col * 2 + 1] = TileObject::None;
+        }
+    }
+    this->cellRow++;
+    if (lastRow)
+        return;
+
+    // Every set continues to the next row at least once
+    std::fill(goesDown.begin(), goesDown.end(), false);
+    std::fill(members.begin(), members.end(), 0);
+    for (int col = 0; col < cols; col++) {
+        int set = findSet(sets[col]);
+        sets[col] = set;
+        if (this->rng.nextInt(++members[set]) == 0)
+            picked[set] = col;
+    }
+    for (int col = 0; col < cols; col++) {
+        down[col] = false;
+        if (this->rng.nextInt(2) == 0) {
+            down[col] = true;
+            goesDown[sets[col]] = true;
+        }
+    }
+    for (int col = 0; col < cols; col++)
+        if (!goesDown[sets[col]] && picked[sets[col]] == col)
+            down[col] = true;
+
+    for (int col = 0; col < cols; col++) {
+        if (down[col])
+            passageTiles[offsetX + col * 2] = TileObject::None;
+        else
+            sets[col] = -1;
+    }
+}
+
+/*
+ * Emits the next row of tiles to the sink
+ *
+ * @return bool False if every row has already been emitted
+ */
+bool EllerStream::step() {
+    if (this->tileRow >= this->height)
+        return false;
+
+    int y = this->tileRow - this->offsetY;
+    const TileObject *row = this->wallTiles.data();
+    if (y >= 0 && y % 2 == 0 && y / 2 < this->rows && this->cols > 0) {
+        carveRow();
+        row = this->cellTiles.data();
+    } else if (y >= 0 && y % 2 == 1 && y / 2 < this->rows - 1) {
+        row = this->passageTiles.data();
+    }
+
+    this->sink.consumeRow(this->tileRow, row, this->width);
+    this->tileRow++;
+    return true;
+}
+
+/*
+ * Emits every remaining row
+ *
+ * @return void
+ */
+void EllerStream::run() {
+    while (step())
+        ;
+}
@@ -143,6 +143,26 @@ bool Player::hasItem(int itemID) const {
     return false;
 }
 
+/*
+ * Gets how the field of view is worked out from the inventory
+ * Headlights & Telescope Glasses keep the whole radius and also show what is
+ * in line of sight beyond it, so they never show less than the radius alone
+ *
+ * @return SightMode
+ */
+SightMode Player::getSightMode() const {
+    if (hasItem(ItemID::Headlights) || hasItem(ItemID::TelescopeGlasses))
+        return SightMode::LineOfSight;
+    return SightMode::Radius;
+}
+
+/*
+ * Gets how far line of sight reaches, twice the FOV with the same cap
+ *
+ * @return int
+ */
+int Player::getSightRange() const { return std::min(this->fov * 2, 10); }
+
 /*
  * Resets player stats before applying bonuses
  *
@@ -177,9 +197,11 @@ void Player::preUpdate() {
  * and recalculates all final stat values.
  *
  * Usage:
- * player.update();
+ * player.update(rng);
+ *
+ * @param rng Source of randomness for items with custom behavior
  */
-void Player::update() {
+void Player::update(Random &rng) {
 
     this->staminaMax = this->baseStaminaMax;
     this->rationRegen = this->baseRationRegen;
@@ -210,7 +232,7 @@ void Player::update() {
             continue;
 
         if (item->hasCustomBehavior) {
-            item->update(*this);
+            item->update(*this, rng);
         }
 
         // Flat bonuses
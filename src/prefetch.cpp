@@ -0,0 +1,105 @@
+#include "include/prefetch.h"
+#include "include/generator.h"
+#include <chrono>
+#include <memory>
+
+bool LevelPrefetcher::Params::operator==(const Params &other) const {
+    return size == other.size && startPos == other.startPos &&
+           itemCount == other.itemCount && type == other.type &&
+           seed == other.seed;
+}
+
+/*
+ * @param async Whether to build requested levels on a worker thread, a
+ *              prefetcher without it always builds in take()
+ */
+LevelPrefetcher::LevelPrefetcher(bool async) : async(async) {}
+
+// Waits for the worker, a level being built can't be abandoned
+LevelPrefetcher::~LevelPrefetcher() { cancel(); }
+
+/*
+ * Builds a level from its parameters
+ * Everything the level needs is created here, so nothing is shared with the
+ * game thread. Large levels are chunked, only the chunks around the start
+ * are generated.
+ *
+ * @param params Parameters of the level
+ * @return Level
+ */
+Level LevelPrefetcher::build(Params params) {
+    if (params.size > CHUNKED_SIZE) {
+        Level level = Level::chunked(params.size, params.startPos,
+                                     params.itemCount, params.type,
+                                     params.seed);
+        level.preload(params.startPos, PRELOAD_RADIUS);
+        return level;
+    }
+    std::unique_ptr<MazeGenerator> generator =
+        MazeGenerator::create(params.type);
+    return Level(params.size, params.startPos, params.itemCount, *generator,
+                 params.seed);
+}
+
+/*
+ * Starts building a level in the background
+ * Does nothing if the same level is already being built
+ *
+ * @param params Parameters of the level
+ * @return void
+ */
+void LevelPrefetcher::request(const Params &params) {
+    if (!this->async || isPending(params))
+        return;
+    cancel();
+    this->pending = params;
+    this->future = std::async(std::launch::async, build, params);
+}
+
+/*
+ * Checks if a level with these parameters has been requested
+ *
+ * @param params Parameters of the level
+ * @return bool
+ */
+bool LevelPrefetcher::isPending(const Params &params) const {
+    return this->future.valid() && this->pending == params;
+}
+
+/*
+ * Checks if the requested level is done building
+ *
+ * @return bool
+ */
+bool LevelPrefetcher::isReady() const {
+    return this->future.valid() &&
+           this->future.wait_for(std::chrono::seconds(0)) ==
+               std::future_status::ready;
+}
+
+/*
+ * Gets the level for these parameters
+ * Moves the prefetched level out if it matches, waiting for the worker if it
+ * isn't done yet. Otherwise the request is dropped and the level is built on
+ * the calling thread.
+ *
+ * @param params Parameters of the level
+ * @return Level
+ */
+Level LevelPrefetcher::take(const Params &params) {
+    if (isPending(params))
+        return this->future.get();
+    cancel();
+    return build(params);
+}
+
+/*
+ * Drops the current request, waiting for the worker to finish with it
+ *
+ * @return void
+ */
+void LevelPrefetcher::cancel() {
+    if (this->future.valid())
+        this->future.wait();
+    this->future = std::future<Level>();
+}
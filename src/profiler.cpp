@@ -0,0 +1,108 @@
+#include "include/profiler.h"
+
+// Last samples of every timer, written in a ring
+static double samples[Profiler::TIMER_COUNT][Profiler::WINDOW];
+static int sampleCount[Profiler::TIMER_COUNT];
+static int nextSample[Profiler::TIMER_COUNT];
+static int counts[Profiler::COUNTER_COUNT];
+
+static Profiler::Clock::time_point frameStart, inputTime;
+static bool inFrame = false, inputPending = false;
+
+/*
+ * Adds a sample to a timer, replacing the oldest one once there are WINDOW
+ *
+ * @param timer Timer to add to
+ * @param ms    Sample in milliseconds
+ * @return void
+ */
+void Profiler::addTime(Timer timer, double ms) {
+    if (timer < 0 || timer >= TIMER_COUNT)
+        return;
+    samples[timer][nextSample[timer]] = ms;
+    nextSample[timer] = (nextSample[timer] + 1) % WINDOW;
+    if (sampleCount[timer] < WINDOW)
+        sampleCount[timer]++;
+}
+
+void Profiler::setCount(Counter counter, int value) {
+    if (counter >= 0 && counter < COUNTER_COUNT)
+        counts[counter] = value;
+}
+
+/*
+ * Gets the average of the last samples of a timer
+ *
+ * @param timer Timer to read
+ * @return double Milliseconds, 0 if there are no samples
+ */
+double Profiler::getAverage(Timer timer) {
+    if (timer < 0 || timer >= TIMER_COUNT || sampleCount[timer] == 0)
+        return 0;
+    double total = 0;
+    for (int i = 0; i < sampleCount[timer]; i++)
+        total += samples[timer][i];
+    return total / sampleCount[timer];
+}
+
+int Profiler::getCount(Counter counter) {
+    if (counter < 0 || counter >= COUNTER_COUNT)
+        return 0;
+    return counts[counter];
+}
+
+/*
+ * Records that an input was just read, the next frame presented answers it
+ *
+ * @return void
+ */
+void Profiler::markInput() {
+    inputTime = Clock::now();
+    inputPending = true;
+}
+
+/*
+ * Starts timing a frame
+ *
+ * @return void
+ */
+void Profiler::beginFrame() {
+    frameStart = Clock::now();
+    inFrame = true;
+}
+
+/*
+ * Ends the frame that was presented, adding its frame time & the latency
+ * of the input it answers
+ *
+ * @return void
+ */
+void Profiler::endFrame() {
+    Clock::time_point now = Clock::now();
+    if (inFrame)
+        addTime(Frame, std::chrono::duration<double, std::milli>(
+                           now - frameStart)
+                           .count());
+    if (inputPending)
+        addTime(Latency, std::chrono::duration<double, std::milli>(
+                             now - inputTime)
+                             .count());
+    inFrame = false;
+    inputPending = false;
+}
+
+/*
+ * Drops every sample & count
+ *
+ * @return void
+ */
+void Profiler::reset() {
+    for (int i = 0; i < TIMER_COUNT; i++) {
+        sampleCount[i] = 0;
+        nextSample[i] = 0;
+    }
+    for (int i = 0; i < COUNTER_COUNT; i++)
+        counts[i] = 0;
+    inFrame = false;
+    inputPending = false;
+}
@@ -0,0 +1,20 @@
+#include "include/random.h"
+
+/*
+ * Constructor for Random
+ * Expands the seed into the full state with SplitMix64, so similar seeds
+ * still give unrelated sequences
+ *
+ * @param seed Seed of the sequence
+ * @return none
+ */
+Random::Random(uint64_t seed) {
+    this->seed = seed;
+    uint64_t x = seed;
+    for (int i = 0; i < 4; i++) {
+        uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        this->state[i] = z ^ (z >> 31);
+    }
+}
@@ -0,0 +1,137 @@
+#include "include/renderer.h"
+#include "include/profiler.h"
+#include "include/utils.h"
+
+/*
+ * Creates the renderer of a backend
+ *
+ * Usage:
+ * auto renderer = Renderer::create(RendererType::Null, 40, 120);
+ *
+ * @param type   Backend to use
+ * @param height Rows of the in-memory backends
+ * @param width  Columns of the in-memory backends
+ * @return std::unique_ptr<Renderer> The renderer
+ */
+std::unique_ptr<Renderer> Renderer::create(RendererType type, int height,
+                                           int width) {
+    switch (type) {
+    case RendererType::Framebuffer:
+        return utils::make_unique<FrameRenderer>(height, width);
+    case RendererType::Null:
+        return utils::make_unique<NullRenderer>(height, width);
+    default:
+        return utils::make_unique<CursesRenderer>();
+    }
+}
+
+#pragma region CURSES
+CursesRenderer::CursesRenderer() : calls(0), lastCalls(0) {}
+
+// The screen is empty until curses is initialized
+int CursesRenderer::getHeight() const {
+    return stdscr == nullptr ? 0 : getmaxy(stdscr);
+}
+int CursesRenderer::getWidth() const {
+    return stdscr == nullptr ? 0 : getmaxx(stdscr);
+}
+
+void CursesRenderer::drawSpan(int y, int x, const chtype *cells, int count) {
+    mvaddchnstr(y, x, cells, count);
+    this->calls++;
+}
+
+/*
+ * Sends what was drawn to the terminal
+ *
+ * @return void
+ */
+void CursesRenderer::endFrame() {
+    refresh();
+    this->lastCalls = this->calls + 1;
+    this->calls = 0;
+    PROFILE_COUNT(Profiler::CursesCalls, this->lastCalls);
+}
+
+const char *CursesRenderer::getName() const { return "curses"; }
+#pragma endregion
+
+#pragma region FRAMEBUFFER
+/*
+ * Constructor for FrameRenderer
+ * Starts with every cell blank
+ *
+ * @param height Number of rows
+ * @param width  Number of columns
+ * @return none
+ */
+FrameRenderer::FrameRenderer(int height, int width)
+    : height(height), width(width), frames(0),
+      cells(std::size_t(height) * width, ' ') {}
+
+int FrameRenderer::getHeight() const { return this->height; }
+int FrameRenderer::getWidth() const { return this->width; }
+
+void FrameRenderer::drawSpan(int y, int x, const chtype *cells, int count) {
+    if (y < 0 || y >= this->height)
+        return;
+    for (int i = 0; i < count && x + i < this->width; i++)
+        if (x + i >= 0)
+            this->cells[std::size_t(y) * this->width + x + i] = cells[i];
+}
+
+void FrameRenderer::endFrame() { this->frames++; }
+
+const char *FrameRenderer::getName() const { return "framebuffer"; }
+
+/*
+ * Gets a cell with its attributes
+ *
+ * @return chtype Blank if the position is outside of the frame
+ */
+chtype FrameRenderer::getCell(int y, int x) const {
+    if (y < 0 || x < 0 || y >= this->height || x >= this->width)
+        return ' ';
+    return this->cells[std::size_t(y) * this->width + x];
+}
+
+/*
+ * Gets the characters of a row, without attributes
+ *
+ * @param y Row to read
+ * @return std::string
+ */
+std::string FrameRenderer::getLine(int y) const {
+    std::string line(this->width, ' ');
+    for (int x = 0; x < this->width; x++)
+        line[x] = char(getCell(y, x) & A_CHARTEXT);
+    return line;
+}
+
+/*
+ * Gets the characters of the whole frame, one line per row
+ *
+ * @return std::string
+ */
+std::string FrameRenderer::toString() const {
+    std::string text;
+    text.reserve(std::size_t(this->height) * (this->width + 1));
+    for (int y = 0; y < this->height; y++)
+        text += getLine(y) + "\n";
+    return text;
+}
+#pragma endregion
+
+#pragma region NULL
+NullRenderer::NullRenderer(int height, int width)
+    : height(height), width(width), frames(0), cells(0), spans(0) {}
+
+int NullRenderer::getHeight() const { return this->height; }
+int NullRenderer::getWidth() const { return this->width; }
+void NullRenderer::drawSpan(int y, int x, const chtype *cells, int count) {
+    this->cells += count;
+    this->spans++;
+}
+void NullRenderer::endFrame() { this->frames++; }
+const char *NullRenderer::getName() const { return "null"; }
+#pragma endregion
@@ -0,0 +1,242 @@
+#include "include/screenbuffer.h"
+#include "include/renderer.h"
+#include <algorithm>
+
+// Front buffer value that never matches a drawn cell, forces a repaint
+static const chtype INVALID_CELL = ~chtype(0);
+
+/*
+ * Counts the decimal digits of a positive number
+ */
+static int digits(int value) {
+    int count = 1;
+    while (value >= 10) {
+        value /= 10;
+        count++;
+    }
+    return count;
+}
+
+/*
+ * Constructor for ScreenBuffer
+ *
+ * @param height Number of rows of the terminal
+ * @param width  Number of columns of the terminal
+ * @return none
+ */
+ScreenBuffer::ScreenBuffer(int height, int width)
+    : height(0), width(0), cursorY(0), cursorX(0), attr(A_NORMAL) {
+    this->lastFrame.cells = 0;
+    this->lastFrame.bytes = 0;
+    this->lastFrame.spans = 0;
+    resize(height, width);
+}
+
+/*
+ * Changes the size of the buffer, the next present repaints every cell
+ *
+ * @param height Number of rows of the terminal
+ * @param width  Number of columns of the terminal
+ * @return void
+ */
+void ScreenBuffer::resize(int height, int width) {
+    this->height = height;
+    this->width = width;
+    this->back.assign(std::size_t(height) * width, ' ');
+    invalidate();
+}
+
+/*
+ * Blanks the back buffer to start a new frame, the terminal is untouched
+ *
+ * @return void
+ */
+void ScreenBuffer::erase() {
+    std::fill(this->back.begin(), this->back.end(), chtype(' '));
+    this->cursorY = 0;
+    this->cursorX = 0;
+}
+
+/*
+ * Starts a new frame from a prebuilt layer instead of blanks, e.g. the parts
+ * of the screen that don't change between frames
+ * A layer of another size is ignored and the frame is blanked instead.
+ *
+ * @param layer Buffer whose frame being drawn is copied
+ * @return void
+ */
+void ScreenBuffer::erase(const ScreenBuffer &layer) {
+    if (layer.height != this->height || layer.width != this->width) {
+        erase();
+        return;
+    }
+    std::copy(layer.back.begin(), layer.back.end(), this->back.begin());
+    this->cursorY = 0;
+    this->cursorX = 0;
+}
+
+/*
+ * Forgets what is on the terminal, e.g. after something else drew on it
+ *
+ * @return void
+ */
+void ScreenBuffer::invalidate() {
+    this->front.assign(this->back.size(), INVALID_CELL);
+}
+
+/*
+ * Gets a cell of the frame being drawn
+ *
+ * @return chtype Blank if the position is outside of the screen
+ */
+chtype ScreenBuffer::getCell(int y, int x) const {
+    if (y < 0 || x < 0 || y >= this->height || x >= this->width)
+        return ' ';
+    return this->back[std::size_t(y) * this->width + x];
+}
+
+/*
+ * Moves the cursor, positions outside of the screen are ignored like curses
+ *
+ * @return void
+ */
+void ScreenBuffer::move(int y, int x) {
+    if (y < 0 || x < 0 || y >= this->height || x >= this->width)
+        return;
+    this->cursorY = y;
+    this->cursorX = x;
+}
+
+/*
+ * Writes text at the cursor with the current attributes
+ * Wraps at the end of a line and stops at the bottom of the screen like
+ * curses, a newline blanks the rest of the line
+ *
+ * @param text Text to write
+ * @return void
+ */
+void ScreenBuffer::addStr(const char *text) {
+    for (; *text; text++) {
+        if (this->cursorY >= this->height)
+            return;
+        chtype *row = &this->back[std::size_t(this->cursorY) * this->width];
+        if (*text == '\n') {
+            for (int x = this->cursorX; x < this->width; x++)
+                row[x] = ' ';
+            this->cursorX = this->width;
+        } else {
+            row[this->cursorX++] = chtype((unsigned char)*text) | this->attr;
+        }
+        if (this->cursorX >= this->width) {
+            this->cursorX = 0;
+            this->cursorY++;
+        }
+    }
+}
+
+void ScreenBuffer::mvAddStr(int y, int x, const char *text) {
+    move(y, x);
+    addStr(text);
+}
+
+/*
+ * Copies a run of prebuilt cells into a row, with their own attributes
+ * The run is clipped to the screen and the cursor doesn't move
+ *
+ * @param y     Row to write to
+ * @param x     Column of the first cell, may be off screen
+ * @param cells Cells to copy
+ * @param count Number of cells
+ * @return void
+ */
+void ScreenBuffer::putCells(int y, int x, const chtype *cells, int count) {
+    if (y < 0 || y >= this->height)
+        return;
+    int first = std::max(0, -x), last = std::min(count, this->width - x);
+    if (first < last)
+        std::copy(cells + first, cells + last,
+                  this->back.begin() + std::size_t(y) * this->width + x +
+                      first);
+}
+
+/*
+ * Turns attributes on, a color pair replaces the current one like curses
+ *
+ * @param attrs Attributes & color pair, e.g. COLOR_PAIR(6) | A_DIM
+ * @return void
+ */
+void ScreenBuffer::attrOn(attr_t attrs) {
+    if (attrs & A_COLOR)
+        this->attr &= ~A_COLOR;
+    this->attr |= attrs;
+}
+
+/*
+ * Turns attributes off, any color pair removes the current one like curses
+ *
+ * @param attrs Attributes & color pair
+ * @return void
+ */
+void ScreenBuffer::attrOff(attr_t attrs) {
+    if (attrs & A_COLOR)
+        this->attr &= ~A_COLOR;
+    this->attr &= ~(attrs & ~A_COLOR);
+}
+
+/*
+ * Writes the cells that changed since the last present to a renderer
+ * Changed cells of a row are sent as runs, one renderer call each. Runs
+ * that are at most MERGE_GAP unchanged cells apart are sent as one, since
+ * rewriting a cell with the same value is cheaper than another call.
+ *
+ * The byte count models what the terminal receives: a cursor move before
+ * each group of changed cells, an attribute change when it differs from the
+ * previous cell written, and the character itself. Unchanged cells inside a
+ * run are skipped by curses, so they aren't counted.
+ *
+ * @param renderer Where the frame goes
+ * @return FrameStats What was sent for this frame
+ */
+ScreenBuffer::FrameStats ScreenBuffer::present(Renderer &renderer) {
+    FrameStats stats = {0, 0, 0};
+    attr_t lastAttr = A_NORMAL;
+    for (int y = 0; y < this->height; y++) {
+        const chtype *row = &this->back[std::size_t(y) * this->width];
+        chtype *shown = &this->front[std::size_t(y) * this->width];
+        int nextX = -1; // Column the terminal cursor is at after a write
+        int spanStart = -1, spanEnd = -1; // Run being built, [start, end)
+        for (int x = 0; x < this->width; x++) {
+            if (row[x] == shown[x])
+                continue;
+            if (x != nextX) // ESC [ row ; col H
+                stats.bytes += 4 + digits(y + 1) + digits(x + 1);
+            attr_t cellAttr = row[x] & A_ATTRIBUTES;
+            if (cellAttr != lastAttr) { // ESC [ ... m, about 12 bytes
+                stats.bytes += 12;
+                lastAttr = cellAttr;
+            }
+            shown[x] = row[x];
+            stats.cells++;
+            stats.bytes++;
+            nextX = x + 1;
+
+            if (spanStart >= 0 && x - spanEnd > MERGE_GAP) {
+                renderer.drawSpan(y, spanStart, row + spanStart,
+                                  spanEnd - spanStart);
+                stats.spans++;
+                spanStart = -1;
+            }
+            if (spanStart < 0)
+                spanStart = x;
+            spanEnd = x + 1;
+        }
+        if (spanStart >= 0) {
+            renderer.drawSpan(y, spanStart, row + spanStart,
+                              spanEnd - spanStart);
+            stats.spans++;
+        }
+    }
+    renderer.endFrame();
+    this->lastFrame = stats;
+    return stats;
+}
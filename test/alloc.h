@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+
+namespace test_alloc {
+/*
+ * Counts the heap allocations made by the current thread while it is alive
+ * Filled by the global operator new replacements in test/main.cpp. Each
+ * thread has its own count, so workers like the level prefetcher don't
+ * show up in a test running on the main thread.
+ *
+ * Usage:
+ * test_alloc::ScopedCounter counter;
+ * level.getView();
+ * assert(counter.count() == 0);
+ */
+class ScopedCounter {
+  private:
+    std::size_t start; // Allocations of the thread when the scope began
+
+  public:
+    ScopedCounter();
+    std::size_t count() const; // Allocations since the scope began
+};
+} // namespace test_alloc
@@ -1,10 +1,14 @@
 #include "../src/include/config.h"
+#include "../src/include/configwatcher.h"
 #include <cassert>
 #include <cstdlib>
+#include <cstdio>
 #include <cstring>
 #include <fstream>
 #include <iostream>
+#include <ncurses.h>
 #include <sys/stat.h>
+#include <vector>
 
 // Helper functions stay the same
 bool fileExists(const std::string &path) {
@@ -164,6 +168,164 @@ void test_config_file_format() {
     std::cout << "Config file format test passed!" << std::endl;
 }
 
+void test_keymap() {
+    std::string testDir = "/tmp/config_test_keymap/";
+    mkdir(testDir.c_str(), 0777);
+    EnvVarGuard guard("XDG_CONFIG_HOME", testDir);
+
+    // Rebound keys, a key bound twice & a binding without a key
+    {
+        std::ofstream file(testDir + CONFIG_FILE);
+        file << "KB_UP=i\nKB_DOWN=k\nKB_LEFT=j\nKB_RIGHT=l\nKB_CONFIRM=f\n"
+             << "KB_CANCEL=x\nKB_USE_PICKAXE=e\nKB_USE_RATION=r\n"
+             << "KB_EXIT=f\nKB_OVERLAY=\n";
+    }
+    Config config;
+    assert(config.getKeyInput('i') == KeyInput::Up);
+    assert(config.getKeyInput('l') == KeyInput::Right);
+    assert(config.getKeyInput('w') == KeyInput::None);
+    assert(config.getKeyInput('f') == KeyInput::Confirm); // First one wins
+    assert(config.getKeyInput(0) == KeyInput::None);
+    assert(config.getKeyInput(ERR) == KeyInput::None);
+    assert(config.getKeyInput(KEY_RESIZE) == KeyInput::None);
+
+    // The keymap only changes when the config is reloaded
+    {
+        std::ofstream file(testDir + CONFIG_FILE);
+        file << "KB_UP=w\nKB_OVERLAY=o\n";
+    }
+    assert(config.getKeyInput('w') == KeyInput::None);
+    config.reload();
+    assert(config.getKeyInput('w') == KeyInput::Up);
+    assert(config.getKeyInput('o') == KeyInput::ToggleOverlay);
+    assert(config.getKeyInput('i') == KeyInput::None);
+    assert(config.getConfig(Config::KB_DOWN) == "s"); // Missing keeps default
+
+    std::cout << "Keymap test passed!" << std::endl;
+}
+
+void test_typed_settings() {
+    std::string testDir = "/tmp/config_test_typed/";
+    mkdir(testDir.c_str(), 0777);
+    EnvVarGuard guard("XDG_CONFIG_HOME", testDir);
+
+    // Keys only match exactly, settings that are missing keep their default
+    {
+        std::ofstream file(testDir + CONFIG_FILE);
+        file << "# Comment\nXKB_UP=z\nKB_UP=i\nSEED=1340\n\n"
+             << "FRAME_CAP=sixty\nRENDER_BACKEND=null\nSHOW_INTRO=no\n"
+             << "KB_UP=k\nTHREADS=-2\nRENDER\n";
+    }
+    Config config;
+    assert(config.getKeyInput('i') == KeyInput::Up);
+    assert(config.getKeyInput('z') == KeyInput::None);
+    assert(config.getKeyInput('k') == KeyInput::None);
+    assert(config.getKeyInput('s') == KeyInput::Down);
+    assert(config.getInt(Config::SEED) == 1340);
+    assert(config.getString(Config::RENDER_BACKEND) == "null");
+    assert(!config.getBool(Config::SHOW_INTRO));
+    assert(config.getInt(Config::FRAME_CAP) == 0);
+    assert(config.getInt(Config::THREADS) == 1);
+
+    // Unknown & repeated keys, bad values & broken lines are reported
+    const std::vector<std::string> &problems = config.getProblems();
+    assert(problems.size() == 5);
+    assert(problems[0] == "config.txt:2: unknown key XKB_UP");
+    assert(problems[1] == "config.txt:6: bad value for FRAME_CAP, using 0");
+    assert(problems[2] ==
+           "config.txt:9: KB_UP is set again, the first value is kept");
+    assert(problems[3] == "config.txt:10: bad value for THREADS, using 1");
+    assert(problems[4] == "config.txt:11: not a KEY=VALUE pair");
+
+    {
+        std::ofstream file(testDir + CONFIG_FILE);
+        file << "RENDER_BACKEND=vulkan\n";
+    }
+    config.reload();
+    assert(config.getString(Config::RENDER_BACKEND) == "curses");
+    assert(config.getProblems().size() == 1);
+    assert(std::string(Config::getName(Config::FRAME_CAP)) == "FRAME_CAP");
+
+    // A new file has every setting with its default
+    std::string freshDir = "/tmp/config_test_typed_fresh/";
+    mkdir(freshDir.c_str(), 0777);
+    remove((freshDir + CONFIG_FILE).c_str());
+    EnvVarGuard freshGuard("XDG_CONFIG_HOME", freshDir);
+    Config fresh;
+    assert(fresh.getProblems().empty());
+    assert(fresh.getBool(Config::SHOW_INTRO));
+    assert(fresh.getString(Config::KB_OVERLAY) == "o");
+
+    std::cout << "Typed settings test passed!" << std::endl;
+}
+
+void test_watcher() {
+    std::string testDir = "/tmp/config_test_watcher/";
+    mkdir(testDir.c_str(), 0777);
+    EnvVarGuard guard("XDG_CONFIG_HOME", testDir);
+    Config config;
+    ConfigWatcher watcher(config.getConfigFilePath());
+    assert(watcher.isActive());
+    assert(!watcher.poll()); // Nothing written yet
+
+    // Another file in the directory doesn't count
+    std::ofstream(testDir + "other.txt") << "x";
+    assert(!watcher.poll());
+
+    // Writing the same text is seen, but nothing is parsed again
+    std::ofstream(testDir + CONFIG_FILE) << "KB_UP=i\n";
+    assert(watcher.poll());
+    assert(!watcher.poll()); // Events are drained
+    assert(config.reloadIfChanged());
+    assert(config.getKeyInput('i') == KeyInput::Up);
+    std::ofstream(testDir + CONFIG_FILE) << "KB_UP=i\n";
+    assert(watcher.poll());
+    assert(!config.reloadIfChanged());
+
+    // Editors that save to a new file & rename it over the old one
+    std::ofstream(testDir + "config.tmp") << "KB_UP=u\nFRAME_CAP=30\n";
+    rename((testDir + "config.tmp").c_str(), (testDir + CONFIG_FILE).c_str());
+    assert(watcher.poll());
+    assert(config.reloadIfChanged());
+    assert(config.getKeyInput('u') == KeyInput::Up);
+    assert(config.getKeyInput('i') == KeyInput::None);
+    assert(config.getInt(Config::FRAME_CAP) == 30);
+
+    std::cout << "Config watcher test passed!" << std::endl;
+}
+
+void test_atomic_save() {
+    std::string testDir = "/tmp/config_test_save/";
+    mkdir(testDir.c_str(), 0777);
+    remove((testDir + CONFIG_FILE).c_str());
+    EnvVarGuard guard("XDG_CONFIG_HOME", testDir);
+
+    // A new config file is written whole, nothing is left next to it
+    Config config;
+    std::ifstream created(testDir + CONFIG_FILE);
+    std::string first;
+    std::getline(created, first);
+    assert(first == "KB_UP=w");
+    assert(!fileExists(testDir + CONFIG_FILE + ".tmp"));
+
+    // Saving replaces the file with the settings, unknown lines are dropped
+    {
+        std::ofstream file(testDir + CONFIG_FILE);
+        file << "KB_UP=i\nBOGUS=1\nFRAME_CAP=60\n";
+    }
+    config.reload();
+    assert(config.save());
+    assert(!config.reloadIfChanged()); // The file matches the settings
+    Config saved;
+    assert(saved.getProblems().empty());
+    assert(saved.getKeyInput('i') == KeyInput::Up);
+    assert(saved.getInt(Config::FRAME_CAP) == 60);
+    assert(saved.getString(Config::KB_DOWN) == "s");
+    assert(!fileExists(testDir + CONFIG_FILE + ".tmp"));
+
+    std::cout << "Atomic save test passed!" << std::endl;
+}
+
 void runAll() {
     std::cout << "Running Config tests..." << std::endl;
     test_constructor_with_xdg_config();
@@ -171,6 +333,10 @@ void runAll() {
     test_default_config_creation();
     test_config_persistence();
     test_config_file_format();
+    test_keymap();
+    test_typed_settings();
+    test_watcher();
+    test_atomic_save();
     std::cout << "All Config tests passed!" << std::endl;
 }
 
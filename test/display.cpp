@@ -1,6 +1,9 @@
 #include "../src/include/display.h"
 #include "../src/include/enums.h"
+#include "../src/include/fovmask.h"
+#include "../src/include/renderer.h"
 #include <cassert>
+#include <cmath>
 #include <iostream>
 #include <string>
 
@@ -81,12 +84,91 @@ void testIsVisible() {
     std::cout << "isVisible test passed!" << std::endl;
 }
 
+void testFovMask() {
+    // Masks match the distance formula they replace, for every radius
+    for (int r = 0; r <= FovMask::MAX_RADIUS; r++) {
+        const FovMask &mask = FovMask::get(r);
+        assert(mask.getRadius() == r);
+        for (int dy = -12; dy <= 12; dy++) {
+            for (int dx = -12; dx <= 12; dx++) {
+                bool expected =
+                    std::round(std::sqrt(double(dy * dy + dx * dx))) <= r;
+                assert(mask.contains(dy, dx) == expected);
+                assert(isVisible(dy, dx, 0, 0, r) == expected);
+            }
+        }
+    }
+    assert(isVisible(0, 0, 0, 12, 12) && !isVisible(0, 0, 0, 13, 12));
+    assert(&FovMask::get(42) == &FovMask::get(FovMask::MAX_RADIUS));
+    std::cout << "FOV mask test passed!" << std::endl;
+}
+
+// Draws one tick of the intro into the framebuffer
+bool drawIntroTick(int tick) {
+    Display::flush();
+    bool playing = Display::drawIntroFrame(tick);
+    Display::present();
+    return playing;
+}
+
+void testIntroTimeline() {
+    Display::setRenderer(Renderer::create(RendererType::Framebuffer, 30, 80));
+    FrameRenderer &frame = static_cast<FrameRenderer &>(Display::getRenderer());
+    int ticks = Display::getIntroTicks();
+    assert(ticks > 0);
+
+    // The credit is revealed one character at a time
+    assert(drawIntroTick(0) && frame.getLine(0).find("P ") == 0);
+    drawIntroTick(35);
+    assert(frame.getLine(0).find("Pres ") == 0);
+
+    // The last frame has both bars & the whole title
+    assert(drawIntroTick(ticks - 1));
+    int top = (30 - 10) / 2;
+    assert(frame.getLine(top) == std::string(80, '='));
+    assert(frame.getLine(top + 9) == std::string(80, '='));
+    assert(frame.getLine(top + 4).find("HHHHHHH  EEEEE    LL       LL") !=
+           std::string::npos);
+    assert(frame.getLine(0).find("Presented") == std::string::npos);
+
+    // Frames only depend on the tick
+    drawIntroTick(ticks / 2);
+    std::string middle = frame.toString();
+    drawIntroTick(10);
+    drawIntroTick(ticks / 2);
+    assert(frame.toString() == middle);
+
+    assert(!drawIntroTick(ticks));
+    Display::setRenderer(Renderer::create(RendererType::Curses));
+    std::cout << "Intro timeline test passed!" << std::endl;
+}
+
+void testFrameCap() {
+    Display::setRenderer(Renderer::create(RendererType::Null, 24, 80));
+    Display::setFrameCap(0);
+    Display::present();
+    assert(Display::isFrameDue()); // No cap, every frame is due
+
+    // 1 frame per second, the next frame isn't due right after a present
+    Display::setFrameCap(1);
+    Display::present();
+    assert(!Display::isFrameDue());
+    Display::setFrameCap(0);
+    assert(Display::isFrameDue());
+
+    Display::setRenderer(Renderer::create(RendererType::Curses));
+    std::cout << "Frame cap test passed!" << std::endl;
+}
+
 void runAll() {
     std::cout << "Running Display tests..." << std::endl;
     testGetTileChar();
     testGetTileColor();
     testMapFov();
     testIsVisible();
+    testFovMask();
+    testIntroTimeline();
+    testFrameCap();
     std::cout << "All Display tests passed!" << std::endl;
 }
 
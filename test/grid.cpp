@@ -0,0 +1,71 @@
+#include "../src/include/grid.h"
+#include <cassert>
+#include <iostream>
+
+namespace grid_tests {
+
+void testConstructor() {
+    Grid<int> grid(3, 4, 1, -1);
+    assert(grid.getHeight() == 3);
+    assert(grid.getWidth() == 4);
+    assert(grid.getStride() == 6);
+    for (int y = 0; y < 3; y++)
+        for (int x = 0; x < 4; x++)
+            assert(grid(y, x) == 1);
+    std::cout << "Constructor test passed!" << std::endl;
+}
+
+void testBorderRing() {
+    Grid<int> grid(3, 4, 1, -1);
+    // Every tile of the ring holds the sentinel
+    for (int x = -1; x <= 4; x++) {
+        assert(grid(-1, x) == -1);
+        assert(grid(3, x) == -1);
+    }
+    for (int y = -1; y <= 3; y++) {
+        assert(grid(y, -1) == -1);
+        assert(grid(y, 4) == -1);
+    }
+    assert(!grid.inBounds(-1, 0));
+    assert(!grid.inBounds(0, 4));
+    assert(grid.inBounds(Vector2D(2, 3)));
+    std::cout << "Border ring test passed!" << std::endl;
+}
+
+void testRowMajorLayout() {
+    Grid<int> grid(3, 4, 0, -1);
+    grid[Vector2D(1, 2)] = 7;
+    assert(grid(1, 2) == 7);
+    assert(grid.row(1)[2] == 7);
+    // Rows are contiguous, one stride apart
+    assert(grid.row(2) - grid.row(1) == grid.getStride());
+    assert(grid.indexOf(-1, -1) == 0);
+    std::cout << "Row-major layout test passed!" << std::endl;
+}
+
+void testView() {
+    Grid<int> grid(3, 4, 0, -1);
+    grid(1, 2) = 7;
+    GridView<int> window = grid.view(1, 1, 2, 3);
+    assert(window.getHeight() == 2 && window.getWidth() == 3);
+    assert(window(0, 1) == 7);
+    assert(window.row(0) == grid.row(1) + 1);
+    assert(window.getStride() == grid.getStride());
+    // Views of the whole grid reach the border ring
+    GridView<int> whole = grid.view();
+    assert(whole(-1, -1) == -1 && whole(3, 4) == -1);
+    assert(whole[Vector2D(1, 2)] == 7);
+    assert(GridView<int>().empty() && !whole.empty());
+    std::cout << "View test passed!" << std::endl;
+}
+
+void runAll() {
+    std::cout << "Running Grid tests..." << std::endl;
+    testConstructor();
+    testBorderRing();
+    testRowMajorLayout();
+    testView();
+    std::cout << "All Grid tests passed!" << std::endl;
+}
+
+} // namespace grid_tests
@@ -0,0 +1,397 @@
+#include "../src/include/chunkmap.h"
+#include "../src/include/level.h"
+#include "../src/include/mazestream.h"
+#include "../src/include/prefetch.h"
+#include "../src/include/vector2d.h"
+#include "alloc.h"
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace level_tests {
+
+// Counts the walkable tiles reachable from start with a flood fill
+int countReachable(const Level &level, Vector2D start) {
+    int size = level.getSize();
+    std::vector<bool> seen(size * size, false);
+    std::vector<Vector2D> stack(1, start);
+    seen[start.y * size + start.x] = true;
+    int count = 0;
+    Vector2D dirs[] = {Vector2D(-1, 0), Vector2D(1, 0), Vector2D(0, -1),
+                       Vector2D(0, 1)};
+    while (!stack.empty()) {
+        Vector2D pos = stack.back();
+        stack.pop_back();
+        count++;
+        for (Vector2D dir : dirs) {
+            Vector2D next = pos + dir;
+            if (!level.isValidMove(next) || seen[next.y * size + next.x])
+                continue;
+            seen[next.y * size + next.x] = true;
+            stack.push_back(next);
+        }
+    }
+    return count;
+}
+
+void testBorder() {
+    Level level(9, Vector2D(0, 0), 4, 1);
+    // Tiles just outside of the maze are part of the border
+    assert(level.getTile(Vector2D(-1, 0)) == TileObject::Border);
+    assert(level.getTile(Vector2D(0, 9)) == TileObject::Border);
+    assert(level.getTile(Vector2D(9, 9)) == TileObject::Border);
+    assert(!level.isValidMove(Vector2D(-1, 0)));
+    assert(!level.isValidMove(Vector2D(0, -1)));
+    assert(level.isValidMove(level.getStart()));
+    // So is anything further out
+    assert(level.getTile(Vector2D(-50, 3)) == TileObject::Border);
+    assert(level.getTile(Vector2D(4, 1000)) == TileObject::Border);
+    assert(!level.isValidMove(Vector2D(100, 100)));
+    std::cout << "Border test passed!" << std::endl;
+}
+
+void testConnectivity() {
+    for (int seed = 0; seed < 20; seed++) {
+        Level level(15, Vector2D(0, 0), 6, seed);
+        int walkable = 0;
+        for (int y = 0; y < 15; y++)
+            for (int x = 0; x < 15; x++)
+                if (level.isValidMove(Vector2D(y, x)))
+                    walkable++;
+        // Every walkable tile, including the exit, is reachable
+        assert(countReachable(level, level.getStart()) == walkable);
+        assert(level.getTile(level.getEnd()) == TileObject::Exit);
+    }
+    std::cout << "Connectivity test passed!" << std::endl;
+}
+
+void testDistanceField() {
+    Vector2D dirs[] = {Vector2D(-1, 0), Vector2D(1, 0), Vector2D(0, -1),
+                       Vector2D(0, 1)};
+    for (int seed = 0; seed < 10; seed++) {
+        Level level(25, Vector2D(0, 0), 6, seed);
+        assert(level.getDistance(level.getStart()) == 0);
+        assert(level.getDistance(Vector2D(-1, 0)) == -1);
+        int open = 0;
+        for (int y = 0; y < 25; y++) {
+            for (int x = 0; x < 25; x++) {
+                Vector2D pos(y, x);
+                int dist = level.getDistance(pos);
+                assert((dist >= 0) == level.isValidMove(pos));
+                if (dist <= 0)
+                    continue;
+                open++;
+                // Every tile is one step further than some neighbour
+                bool hasPrev = false;
+                for (Vector2D dir : dirs)
+                    hasPrev |= level.getDistance(pos + dir) == dist - 1;
+                assert(hasPrev);
+            }
+        }
+        assert(int(level.getPathTiles().size()) == open + 1);
+        int exitDist = level.getDistance(level.getEnd());
+        assert(exitDist >= std::min(std::max(25, level.getMaxDistance() / 2),
+                                    level.getMaxDistance()));
+    }
+    std::cout << "Distance field test passed!" << std::endl;
+}
+
+void testItemCount() {
+    int counts[] = {0, 3, 4, 12};
+    for (int count : counts) {
+        Level level(21, Vector2D(0, 0), count, count);
+        int items = 0;
+        for (int y = 0; y < 21; y++) {
+            for (int x = 0; x < 21; x++) {
+                TileObject tile = level.getTile(Vector2D(y, x));
+                if (tile == TileObject::Ration || tile == TileObject::Chest ||
+                    tile == TileObject::Pickaxe ||
+                    tile == TileObject::EnergyDrink)
+                    items++;
+            }
+        }
+        assert(items == count);
+    }
+    std::cout << "Item count test passed!" << std::endl;
+}
+
+void testAllGenerators() {
+    GeneratorType types[] = {GeneratorType::Prim,    GeneratorType::PrimBitboard,
+                             GeneratorType::Backtracker, GeneratorType::Kruskal,
+                             GeneratorType::Wilson,  GeneratorType::Eller};
+    int sizes[] = {5, 8, 21};
+    for (GeneratorType type : types) {
+        std::unique_ptr<MazeGenerator> generator = MazeGenerator::create(type);
+        for (int size : sizes) {
+            Level level(size, Vector2D(0, 0), 4, *generator, size);
+            int walkable = 0;
+            for (int y = 0; y < size; y++)
+                for (int x = 0; x < size; x++)
+                    if (level.isValidMove(Vector2D(y, x)))
+                        walkable++;
+            assert(countReachable(level, level.getStart()) == walkable);
+            assert(level.getTile(level.getEnd()) == TileObject::Exit);
+        }
+    }
+    std::cout << "All generators test passed!" << std::endl;
+}
+
+void testSameSeedSameLevel() {
+    Level a(31, Vector2D(0, 0), 8, 99), b(31, Vector2D(0, 0), 8, 99);
+    for (int y = 0; y < 31; y++)
+        for (int x = 0; x < 31; x++)
+            assert(a.getTile(Vector2D(y, x)) == b.getTile(Vector2D(y, x)));
+    std::cout << "Same seed same level test passed!" << std::endl;
+}
+
+void testBitboardMatchesScalar() {
+    // Sizes around the 64-bit word boundary of the bit rows
+    int sizes[] = {5, 62, 63, 64, 65, 130};
+    for (int size : sizes) {
+        for (int seed = 0; seed < 5; seed++) {
+            PrimGenerator scalarGenerator(GenerationMode::Scalar);
+            PrimGenerator bitboardGenerator(GenerationMode::Bitboard);
+            Level scalar(size, Vector2D(0, 0), 4, scalarGenerator, seed);
+            Level bitboard(size, Vector2D(0, 0), 4, bitboardGenerator, seed);
+            for (int y = -1; y <= size; y++)
+                for (int x = -1; x <= size; x++)
+                    assert(scalar.getTile(Vector2D(y, x)) ==
+                           bitboard.getTile(Vector2D(y, x)));
+        }
+    }
+    std::cout << "Bitboard matches scalar test passed!" << std::endl;
+}
+
+// Sink that checks rows arrive once each, in order
+class OrderSink : public RowSink {
+  public:
+    int nextRow = 0;
+    void consumeRow(int y, const TileObject *row, int width) {
+        assert(y == nextRow);
+        nextRow++;
+    }
+};
+
+void testEllerStream() {
+    OrderSink order;
+    Random rng(1);
+    EllerStream stream(40, 9, Vector2D(1, 0), rng, order);
+    stream.run();
+    assert(order.nextRow == 40);
+    assert(!stream.step());
+
+    // Rows written as text, walls as '#'
+    std::stringstream text;
+    FileSink fileSink(text);
+    EllerStream(5, 5, Vector2D(0, 0), rng, fileSink).run();
+    std::string line;
+    int lines = 0;
+    while (std::getline(text, line)) {
+        assert(line.size() == 5);
+        // Cells are never walls
+        if (lines % 2 == 0)
+            assert(line[0] == ' ' && line[2] == ' ' && line[4] == ' ');
+        lines++;
+    }
+    assert(lines == 5);
+    std::cout << "Eller stream test passed!" << std::endl;
+}
+
+bool sameLevel(const Level &a, const Level &b) {
+    if (a.getSize() != b.getSize() || !(a.getEnd() == b.getEnd()))
+        return false;
+    for (int y = 0; y < a.getSize(); y++)
+        for (int x = 0; x < a.getSize(); x++)
+            if (a.getTile(Vector2D(y, x)) != b.getTile(Vector2D(y, x)))
+                return false;
+    return true;
+}
+
+void testPrefetch() {
+    LevelPrefetcher::Params params = {41, Vector2D(0, 0), 6,
+                                      GeneratorType::Wilson, 7};
+    LevelPrefetcher::Params other = params;
+    other.itemCount = 8;
+    std::unique_ptr<MazeGenerator> generator =
+        MazeGenerator::create(GeneratorType::Wilson);
+    Level expected(41, Vector2D(0, 0), 6, *generator, 7);
+    Level expectedOther(41, Vector2D(0, 0), 8, *generator, 7);
+
+    // Matching request is handed over
+    LevelPrefetcher prefetcher;
+    prefetcher.request(params);
+    assert(prefetcher.isPending(params));
+    assert(sameLevel(prefetcher.take(params), expected));
+    assert(!prefetcher.isPending(params));
+
+    // Mismatched request falls back to building synchronously
+    prefetcher.request(params);
+    assert(sameLevel(prefetcher.take(other), expectedOther));
+
+    // Without a worker thread the result is the same
+    LevelPrefetcher sync(false);
+    sync.request(params);
+    assert(!sync.isPending(params));
+    assert(sameLevel(sync.take(params), expected));
+    std::cout << "Prefetch test passed!" << std::endl;
+}
+
+void testChunkedLevel() {
+    GeneratorType types[] = {GeneratorType::Prim, GeneratorType::Backtracker,
+                             GeneratorType::Kruskal, GeneratorType::Wilson,
+                             GeneratorType::Eller};
+    // Sizes with full, partial & single-column last chunks
+    int sizes[] = {64, 150, 129};
+    for (GeneratorType type : types) {
+        for (int size : sizes) {
+            Level level =
+                Level::chunked(size, Vector2D(0, 0), 20, type, size, 4);
+            assert(level.isChunked());
+            int walkable = 0, items = 0;
+            for (int y = 0; y < size; y++) {
+                for (int x = 0; x < size; x++) {
+                    TileObject tile = level.getTile(Vector2D(y, x));
+                    walkable += level.isValidMove(Vector2D(y, x));
+                    items += tile != TileObject::None &&
+                             tile != TileObject::Wall &&
+                             tile != TileObject::Exit;
+                }
+            }
+            assert(items == 20);
+            assert(level.getTile(level.getEnd()) == TileObject::Exit);
+            assert(level.getTile(Vector2D(-1, 0)) == TileObject::Border);
+            assert(level.getTile(Vector2D(0, size)) == TileObject::Border);
+            // Doors connect every chunk
+            assert(countReachable(level, level.getStart()) == walkable);
+        }
+    }
+    std::cout << "Chunked level test passed!" << std::endl;
+}
+
+void testChunkEviction() {
+    // One chunk in memory regenerates on almost every read
+    ChunkMap small(200, GeneratorType::Kruskal, 9, 1);
+    ChunkMap large(200, GeneratorType::Kruskal, 9, 64);
+    small.set(3, 3, TileObject::Ink);
+    large.set(3, 3, TileObject::Ink);
+    for (int x = 0; x < 200; x++)
+        for (int y = 0; y < 200; y++)
+            assert(small.get(y, x) == large.get(y, x));
+    assert(small.get(3, 3) == TileObject::Ink);
+    assert(small.getLoadedChunks() == 1);
+    assert(large.getLoadedChunks() == 16);
+    assert(large.getGenerated() == 16);
+    assert(small.getGenerated() > 16);
+
+    // Preloading generates the chunks ahead of the reads
+    ChunkMap preloaded(1000, GeneratorType::Backtracker, 1, 64);
+    preloaded.preload(Vector2D(500, 500), 42);
+    int loaded = preloaded.getLoadedChunks();
+    assert(loaded == 4);
+    preloaded.get(500, 500);
+    assert(int(preloaded.getGenerated()) == loaded);
+    std::cout << "Chunk eviction test passed!" << std::endl;
+}
+
+void testViews() {
+    Level level(33, Vector2D(0, 0), 6, 4);
+    Level chunked =
+        Level::chunked(150, Vector2D(0, 0), 6, GeneratorType::Kruskal, 4);
+    chunked.getView(60, 60, 21, 19); // Sizes the reused buffer
+
+    test_alloc::ScopedCounter counter;
+    TileView whole = level.getView();
+    TileView window = level.getView(-1, 10, 21, 19);
+    const TileObject *row = level.getRow(5);
+    TileView chunkedWindow = chunked.getView(60, 60, 21, 19);
+    assert(counter.count() == 0);
+
+    assert(whole.getHeight() == 33 && whole.getWidth() == 33);
+    assert(whole(-1, 0) == TileObject::Border);
+    assert(window(0, 0) == TileObject::Border);
+    assert(chunked.getView().empty());
+    for (int y = 0; y < 21; y++) {
+        for (int x = 0; x < 19; x++) {
+            assert(window(y, x) == level.getTile(Vector2D(y - 1, x + 10)));
+            assert(chunkedWindow(y, x) ==
+                   chunked.getTile(Vector2D(60 + y, 60 + x)));
+        }
+    }
+    for (int x = 0; x < 33; x++)
+        assert(row[x] == level.getTile(Vector2D(5, x)));
+    assert(whole.row(1) - whole.row(0) == whole.getStride());
+    std::cout << "Views test passed!" << std::endl;
+}
+
+// Open room with a wall down column 6 that only has a gap on row 0
+class RoomGenerator : public MazeGenerator {
+  public:
+    void generate(TileMap &maze, Vector2D start, Random &rng) {
+        for (int y = 0; y < maze.getHeight(); y++)
+            for (int x = 0; x < maze.getWidth(); x++)
+                maze(y, x) =
+                    x == 6 && y > 0 ? TileObject::Wall : TileObject::None;
+    }
+    const char *getName() const { return "Room"; }
+};
+
+void testSight() {
+    RoomGenerator generator;
+    Level level(21, Vector2D(10, 2), 0, generator, 1);
+    const FovMask &mask = FovMask::get(10);
+    const Sight &sight = level.getSight(Vector2D(10, 2), 10);
+
+    // Nothing blocks the tiles up to the wall, so they match the radius test
+    for (int y = 0; y < 21; y++)
+        for (int x = 0; x <= 6; x++)
+            assert(sight.contains(y - 10, x - 2) ==
+                   mask.contains(y - 10, x - 2));
+    assert(!sight.contains(0, 6));  // Behind the wall
+    assert(!sight.contains(5, 10)); // Out of range
+    assert(sight.contains(0, 4));   // The wall itself
+
+    // Cached until a wall changes, other tiles don't matter
+    int count = sight.count();
+    level.setTile(Vector2D(10, 3), TileObject::Ink);
+    assert(&level.getSight(Vector2D(10, 2), 10) == &sight);
+    level.setTile(Vector2D(10, 6), TileObject::None);
+    const Sight &opened = level.getSight(Vector2D(10, 2), 10);
+    assert(opened.contains(0, 6) && opened.count() > count);
+
+    // Only the lit tiles are read, far fewer than the whole radius in a maze
+    Level maze(1001, Vector2D(0, 0), 0, 1340);
+    const std::vector<Vector2D> &path = maze.getPathTiles();
+    int visible = 0, area = 0;
+    for (std::size_t i = 0; i < path.size(); i += path.size() / 100) {
+        visible += maze.getSight(path[i], 10).count();
+        for (int dy = -10; dy <= 10; dy++)
+            for (int dx = -10; dx <= 10; dx++)
+                area += mask.contains(dy, dx);
+    }
+    assert(visible * 4 < area);
+    std::cout << "Sight test passed!" << std::endl;
+}
+
+void runAll() {
+    std::cout << "Running Level tests..." << std::endl;
+    testBorder();
+    testConnectivity();
+    testDistanceField();
+    testItemCount();
+    testAllGenerators();
+    testSameSeedSameLevel();
+    testBitboardMatchesScalar();
+    testEllerStream();
+    testPrefetch();
+    testChunkedLevel();
+    testChunkEviction();
+    testViews();
+    testSight();
+    std::cout << "All Level tests passed!" << std::endl;
+}
+
+} // namespace level_tests
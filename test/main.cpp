@@ -1,4 +1,45 @@
+#include "alloc.h"
+#include <cstdlib>
 #include <iostream>
+#include <new>
+
+#pragma region ALLOCATION COUNTER
+// Allocations made by each thread, only read through ScopedCounter
+static thread_local std::size_t threadAllocations = 0;
+
+void *operator new(std::size_t size) {
+    threadAllocations++;
+    void *ptr = std::malloc(size == 0 ? 1 : size);
+    if (ptr == nullptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+
+void *operator new[](std::size_t size) { return operator new(size); }
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+    threadAllocations++;
+    return std::malloc(size == 0 ? 1 : size);
+}
+void *operator new[](std::size_t size, const std::nothrow_t &tag) noexcept {
+    return operator new(size, tag);
+}
+void operator delete[](void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void *ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete(void *ptr, const std::nothrow_t &) noexcept {
+    std::free(ptr);
+}
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept {
+    std::free(ptr);
+}
+
+test_alloc::ScopedCounter::ScopedCounter() : start(threadAllocations) {}
+std::size_t test_alloc::ScopedCounter::count() const {
+    return threadAllocations - this->start;
+}
+#pragma endregion
 
 namespace player_tests {
 void runAll();
@@ -20,6 +61,30 @@ namespace config_tests {
 void runAll();
 }
 
+namespace grid_tests {
+void runAll();
+}
+
+namespace level_tests {
+void runAll();
+}
+
+namespace random_tests {
+void runAll();
+}
+
+namespace screenbuffer_tests {
+void runAll();
+}
+
+namespace renderer_tests {
+void runAll();
+}
+
+namespace profiler_tests {
+void runAll();
+}
+
 int main() {
     std::cout << "Running all tests..." << std::endl;
 
@@ -28,6 +93,12 @@ int main() {
     utils_tests::runAll();
     display_tests::runAll();
     config_tests::runAll();
+    grid_tests::runAll();
+    level_tests::runAll();
+    random_tests::runAll();
+    screenbuffer_tests::runAll();
+    renderer_tests::runAll();
+    profiler_tests::runAll();
 
     std::cout << "All tests completed successfully!" << std::endl;
     return 0;
@@ -0,0 +1,95 @@
+#include "../src/include/display.h"
+#include "../src/include/level.h"
+#include "../src/include/player.h"
+#include "../src/include/profiler.h"
+#include "../src/include/renderer.h"
+#include <cassert>
+#include <iostream>
+#include <string>
+
+namespace profiler_tests {
+
+void testRollingAverage() {
+    Profiler::reset();
+    assert(Profiler::getAverage(Profiler::Draw) == 0);
+    Profiler::addTime(Profiler::Draw, 1.0);
+    Profiler::addTime(Profiler::Draw, 3.0);
+    assert(Profiler::getAverage(Profiler::Draw) == 2.0);
+
+    // Only the last WINDOW samples count
+    for (int i = 0; i < Profiler::WINDOW; i++)
+        Profiler::addTime(Profiler::Draw, 5.0);
+    assert(Profiler::getAverage(Profiler::Draw) == 5.0);
+
+    Profiler::setCount(Profiler::TilesDrawn, 42);
+    assert(Profiler::getCount(Profiler::TilesDrawn) == 42);
+    Profiler::reset();
+    assert(Profiler::getCount(Profiler::TilesDrawn) == 0);
+    std::cout << "Profiler rolling average test passed!" << std::endl;
+}
+
+void testScopedTimer() {
+    double time = -1;
+    {
+        ScopedTimer timer(time);
+        volatile int sum = 0;
+        for (int i = 0; i < 100000; i++)
+            sum += i;
+    }
+    assert(time >= 0);
+
+    // A frame only has a latency when an input was read before it
+    Profiler::reset();
+    Profiler::beginFrame();
+    Profiler::endFrame();
+    assert(Profiler::getAverage(Profiler::Frame) >= 0);
+    assert(Profiler::getAverage(Profiler::Latency) == 0);
+    Profiler::markInput();
+    Profiler::beginFrame();
+    Profiler::endFrame();
+    assert(Profiler::getAverage(Profiler::Latency) > 0);
+    std::cout << "ScopedTimer test passed!" << std::endl;
+}
+
+void testOverlay() {
+    Display::setRenderer(Renderer::create(RendererType::Framebuffer, 40, 120));
+    FrameRenderer &frame = static_cast<FrameRenderer &>(Display::getRenderer());
+    Level level(51, Vector2D(0, 0), 4, 1340);
+    Player player;
+    std::string text;
+
+    Profiler::reset();
+    assert(!Display::isOverlayShown());
+    Display::toggleOverlay();
+    for (int i = 0; i < 2; i++) {
+        Display::flush();
+        Display::drawLevel(level, player, 1, text);
+        Display::present();
+    }
+    if (Profiler::isEnabled()) {
+        assert(frame.getLine(0).find("frame") == 0);
+        assert(frame.getLine(4).find(" tiles, ") != std::string::npos);
+        assert(Profiler::getCount(Profiler::TilesDrawn) > 0);
+        assert(level.getGenerationTime() > 0);
+    } else {
+        assert(frame.getLine(0).find("Profiler compiled out") == 0);
+    }
+
+    Display::toggleOverlay();
+    Display::flush();
+    Display::drawLevel(level, player, 1, text);
+    Display::present();
+    assert(frame.getLine(0).find("frame") == std::string::npos);
+    Display::setRenderer(Renderer::create(RendererType::Curses));
+    std::cout << "Overlay test passed!" << std::endl;
+}
+
+void runAll() {
+    std::cout << "Running Profiler tests..." << std::endl;
+    testRollingAverage();
+    testScopedTimer();
+    testOverlay();
+    std::cout << "All Profiler tests passed!" << std::endl;
+}
+
+} // namespace profiler_tests
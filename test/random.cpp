@@ -0,0 +1,90 @@
+#include "../src/include/random.h"
+#include <cassert>
+#include <iostream>
+#include <set>
+#include <vector>
+
+namespace random_tests {
+
+void testSameSeedSameSequence() {
+    Random a(1340), b(1340), c(1341);
+    bool differs = false;
+    for (int i = 0; i < 100; i++) {
+        uint64_t value = a.next();
+        assert(value == b.next());
+        differs |= value != c.next();
+    }
+    assert(differs);
+    assert(a.getSeed() == 1340);
+    std::cout << "Same seed same sequence test passed!" << std::endl;
+}
+
+void testNextIntBounds() {
+    Random rng(7);
+    int bounds[] = {1, 2, 3, 7, 100, 1000000};
+    for (int bound : bounds) {
+        for (int i = 0; i < 1000; i++) {
+            int value = rng.nextInt(bound);
+            assert(value >= 0 && value < bound);
+        }
+    }
+    std::cout << "nextInt bounds test passed!" << std::endl;
+}
+
+void testNextIntUniform() {
+    // Every bucket should be close to 1/6 of the draws
+    Random rng(42);
+    int counts[6] = {0};
+    for (int i = 0; i < 60000; i++)
+        counts[rng.nextInt(6)]++;
+    for (int count : counts)
+        assert(count > 9500 && count < 10500);
+    std::cout << "nextInt uniform test passed!" << std::endl;
+}
+
+void testSample() {
+    Random rng(5);
+    std::vector<int> list;
+    for (int i = 0; i < 100; i++)
+        list.push_back(i);
+    auto even = [](int value) { return value % 2 == 0; };
+
+    // Distinct elements that match the predicate
+    std::vector<int> picked = rng.sample(list, 10, even);
+    assert(picked.size() == 10);
+    std::set<int> unique(picked.begin(), picked.end());
+    assert(unique.size() == 10);
+    for (int value : picked)
+        assert(even(value));
+
+    // Not enough matches gives all of them
+    assert(rng.sample(list, 80, even).size() == 50);
+    assert(rng.sample(list, 0, even).empty());
+
+    // Every element & every slot is equally likely
+    int counts[10] = {0}, firstSlot[10] = {0};
+    std::vector<int> small(list.begin(), list.begin() + 10);
+    auto all = [](int) { return true; };
+    for (int i = 0; i < 20000; i++) {
+        std::vector<int> draw = rng.sample(small, 3, all);
+        for (int value : draw)
+            counts[value]++;
+        firstSlot[draw[0]]++;
+    }
+    for (int i = 0; i < 10; i++) {
+        assert(counts[i] > 5600 && counts[i] < 6400);
+        assert(firstSlot[i] > 1700 && firstSlot[i] < 2300);
+    }
+    std::cout << "Sample test passed!" << std::endl;
+}
+
+void runAll() {
+    std::cout << "Running Random tests..." << std::endl;
+    testSameSeedSameSequence();
+    testNextIntBounds();
+    testNextIntUniform();
+    testSample();
+    std::cout << "All Random tests passed!" << std::endl;
+}
+
+} // namespace random_tests
@@ -0,0 +1,121 @@
+#include "../src/include/display.h"
+#include "../src/include/level.h"
+#include "../src/include/player.h"
+#include "../src/include/renderer.h"
+#include <cassert>
+#include <iostream>
+#include <memory>
+#include <string>
+
+namespace renderer_tests {
+
+void testCreate() {
+    std::unique_ptr<Renderer> frame =
+        Renderer::create(RendererType::Framebuffer, 3, 4);
+    std::unique_ptr<Renderer> null = Renderer::create(RendererType::Null);
+    assert(std::string(frame->getName()) == "framebuffer");
+    assert(frame->getHeight() == 3 && frame->getWidth() == 4);
+    assert(std::string(null->getName()) == "null");
+    assert(null->getHeight() == 24 && null->getWidth() == 80);
+    // Curses has no screen before it is initialized
+    std::unique_ptr<Renderer> curses = Renderer::create(RendererType::Curses);
+    assert(curses->getHeight() == 0 && curses->getWidth() == 0);
+    std::cout << "Renderer create test passed!" << std::endl;
+}
+
+void testFrameRenderer() {
+    FrameRenderer frame(2, 3);
+    chtype first[] = {chtype('a') | A_BOLD};
+    chtype second[] = {'b', 'c', 'd'};
+    frame.drawSpan(0, 1, first, 1);
+    frame.drawSpan(1, 2, second, 3); // Clipped to the frame
+    frame.drawSpan(5, 0, second, 3); // Outside of the frame, ignored
+    frame.endFrame();
+    assert(frame.getCell(0, 1) == (chtype('a') | A_BOLD));
+    assert(frame.getLine(0) == " a ");
+    assert(frame.toString() == " a \n  b\n");
+    assert(frame.getFrames() == 1);
+    std::cout << "FrameRenderer test passed!" << std::endl;
+}
+
+// Draws a level into the framebuffer and gets the frame as text
+std::string drawLevelFrame(const Level &level, const Player &player) {
+    std::string text;
+    Display::flush();
+    Display::drawLevel(level, player, 1, text);
+    Display::present();
+    return static_cast<FrameRenderer &>(Display::getRenderer()).toString();
+}
+
+void testHeadlessDisplay() {
+    Display::setRenderer(Renderer::create(RendererType::Framebuffer, 40, 120));
+    FrameRenderer &frame = static_cast<FrameRenderer &>(Display::getRenderer());
+
+    Display::flush();
+    Display::drawMainMenu(0);
+    Display::present();
+    std::string menu = frame.toString();
+    assert(menu.find("< New Game >") != std::string::npos);
+    assert(menu.find(" <Help> ") != std::string::npos);
+
+    // Same level & player, same frame, with the player in the middle
+    Level level(51, Vector2D(0, 0), 4, 1340);
+    Player player;
+    player.setPos(Vector2D(10, 10));
+    std::string first = drawLevelFrame(level, player);
+    assert(first == drawLevelFrame(level, player));
+    assert(frame.getLine(22).substr(60, 2) == "P1");
+
+    // Only the cells that changed reach the renderer
+    Display::setRenderer(Renderer::create(RendererType::Null, 40, 120));
+    NullRenderer &null = static_cast<NullRenderer &>(Display::getRenderer());
+    std::string text;
+    for (int i = 0; i < 2; i++) {
+        Display::flush();
+        Display::drawLevel(level, player, 1, text);
+        Display::present();
+    }
+    assert(null.getFrames() == 2 && null.getCells() == 40 * 120);
+
+    Display::setRenderer(Renderer::create(RendererType::Curses));
+    std::cout << "Headless Display test passed!" << std::endl;
+}
+
+void testHUD() {
+    Display::setRenderer(Renderer::create(RendererType::Framebuffer, 40, 120));
+    FrameRenderer &frame = static_cast<FrameRenderer &>(Display::getRenderer());
+    Level level(51, Vector2D(0, 0), 4, 1340);
+    Player player;
+    player.setPos(Vector2D(10, 10));
+
+    // Stats follow the player, the border comes from the cached layer
+    player.setStamina(42);
+    drawLevelFrame(level, player);
+    assert(frame.getLine(9).find("SP: 42/") != std::string::npos);
+    assert(frame.getLine(7).substr(38, 2) == " +");
+    player.setStamina(7);
+    drawLevelFrame(level, player);
+    assert(frame.getLine(9).find("SP: 7/") != std::string::npos);
+    assert(frame.getLine(9).find("SP: 42/") == std::string::npos);
+
+    // The layer is drawn again for a new screen size
+    Display::setRenderer(Renderer::create(RendererType::Framebuffer, 30, 80));
+    FrameRenderer &small = static_cast<FrameRenderer &>(Display::getRenderer());
+    drawLevelFrame(level, player);
+    assert(small.getLine(2).substr(18, 2) == " +");
+    assert(small.getLine(4).find("SP: 7/") != std::string::npos);
+
+    Display::setRenderer(Renderer::create(RendererType::Curses));
+    std::cout << "Level HUD test passed!" << std::endl;
+}
+
+void runAll() {
+    std::cout << "Running Renderer tests..." << std::endl;
+    testCreate();
+    testFrameRenderer();
+    testHeadlessDisplay();
+    testHUD();
+    std::cout << "All Renderer tests passed!" << std::endl;
+}
+
+} // namespace renderer_tests
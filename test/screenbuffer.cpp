@@ -0,0 +1,108 @@
+#include "../src/include/renderer.h"
+#include "../src/include/screenbuffer.h"
+#include <cassert>
+#include <iostream>
+#include <ncurses.h>
+
+namespace screenbuffer_tests {
+
+void testDrawing() {
+    ScreenBuffer screen(3, 5);
+    screen.attrOn(COLOR_PAIR(2) | A_BOLD);
+    screen.mvAddStr(0, 3, "abc"); // Wraps to the next line
+    assert(screen.getCell(0, 3) == (chtype('a') | COLOR_PAIR(2) | A_BOLD));
+    assert((screen.getCell(1, 0) & A_CHARTEXT) == 'c');
+
+    // A color pair replaces the current one, attrOff of any pair removes it
+    screen.attrOn(COLOR_PAIR(4));
+    screen.mvAddStr(2, 0, "x");
+    assert(screen.getCell(2, 0) == (chtype('x') | COLOR_PAIR(4) | A_BOLD));
+    screen.attrOff(COLOR_PAIR(1) | A_BOLD);
+    screen.mvAddStr(2, 1, "y");
+    assert(screen.getCell(2, 1) == chtype('y'));
+
+    // Moves outside of the screen keep the cursor where it was
+    screen.move(10, 10);
+    screen.addStr("z");
+    assert((screen.getCell(2, 2) & A_CHARTEXT) == 'z');
+    // Writing stops at the bottom of the screen
+    screen.mvAddStr(2, 4, "123456");
+    assert((screen.getCell(2, 4) & A_CHARTEXT) == '1');
+
+    screen.erase();
+    assert(screen.getCell(0, 3) == chtype(' '));
+
+    // A frame can start from a layer of the same size instead of blanks
+    ScreenBuffer layer(3, 5), small(2, 5);
+    layer.mvAddStr(1, 1, "L");
+    screen.mvAddStr(0, 0, "old");
+    screen.erase(layer);
+    assert((screen.getCell(1, 1) & A_CHARTEXT) == 'L');
+    assert(screen.getCell(0, 0) == chtype(' '));
+    screen.erase(small);
+    assert(screen.getCell(1, 1) == chtype(' '));
+    std::cout << "ScreenBuffer drawing test passed!" << std::endl;
+}
+
+void testPresentOnlyChanges() {
+    FrameRenderer frame(24, 80);
+    ScreenBuffer screen(24, 80);
+    screen.mvAddStr(5, 10, "Hello");
+    // The first frame repaints every cell
+    assert(screen.present(frame).cells == 24 * 80);
+
+    screen.erase();
+    screen.mvAddStr(5, 10, "Hello");
+    ScreenBuffer::FrameStats same = screen.present(frame);
+    assert(same.cells == 0 && same.bytes == 0);
+
+    screen.erase();
+    screen.mvAddStr(5, 10, "Help!");
+    ScreenBuffer::FrameStats changed = screen.present(frame);
+    assert(changed.cells == 2); // "lo" -> "p!"
+    assert(screen.getLastFrame().bytes == changed.bytes);
+    assert(changed.bytes > 2);
+    assert((frame.getCell(5, 13) & A_CHARTEXT) == 'p');
+
+    screen.invalidate();
+    assert(screen.present(frame).cells == 24 * 80);
+    assert(frame.getFrames() == 4);
+    std::cout << "ScreenBuffer present test passed!" << std::endl;
+}
+
+void testSpans() {
+    NullRenderer null(3, 40);
+    ScreenBuffer screen(3, 40);
+    screen.present(null);
+    assert(screen.getLastFrame().spans == 3); // One per row
+
+    // Changes a few cells apart are one run, far apart are two
+    screen.mvAddStr(0, 0, "a");
+    screen.mvAddStr(0, 1 + ScreenBuffer::MERGE_GAP, "b");
+    screen.mvAddStr(1, 0, "c");
+    screen.mvAddStr(1, 2 + ScreenBuffer::MERGE_GAP, "d");
+    long before = null.getCells();
+    ScreenBuffer::FrameStats stats = screen.present(null);
+    assert(stats.cells == 4 && stats.spans == 3);
+    assert(null.getCells() - before == ScreenBuffer::MERGE_GAP + 2 + 2);
+
+    // Prebuilt cells keep their attributes & are clipped to the screen
+    chtype cells[] = {chtype('x') | A_BOLD, 'y', 'z'};
+    screen.putCells(2, 38, cells, 3);
+    screen.putCells(2, -2, cells, 3);
+    screen.putCells(5, 0, cells, 3);
+    assert(screen.getCell(2, 38) == (chtype('x') | A_BOLD));
+    assert(screen.getCell(2, 39) == chtype('y'));
+    assert(screen.getCell(2, 0) == chtype('z'));
+    std::cout << "ScreenBuffer spans test passed!" << std::endl;
+}
+
+void runAll() {
+    std::cout << "Running ScreenBuffer tests..." << std::endl;
+    testDrawing();
+    testPresentOnlyChanges();
+    testSpans();
+    std::cout << "All ScreenBuffer tests passed!" << std::endl;
+}
+
+} // namespace screenbuffer_tests